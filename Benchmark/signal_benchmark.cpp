@@ -0,0 +1,294 @@
+/*
+	信号槽的benchmark,结果以CSV格式输出(见Talg::CsvReporter),
+	每种情况都与std::vector<std::function>的实现作对比.
+	用法: Benchmark [output.csv] [--quick]
+*/
+#include <Talg/slotlist.h>
+#include <Talg/homogeneous_signal.h>
+#include <Talg/timing_wheel.h>
+#include <Talg/signal_ops.h>
+#include <Talg/benchmark.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Talg;
+
+namespace {
+	using Clock = std::chrono::steady_clock;
+	using Baseline = std::vector<std::function<void(int)>>;
+
+	long long sink_value = 0;
+
+	struct Adder {
+		int id;
+		void operator()(int v)const {
+			sink_value += v + id;
+		}
+		bool operator==(const Adder& rhs)const noexcept {
+			return id == rhs.id;
+		}
+	};
+
+	struct Target {
+		long long sum = 0;
+		void add(int v) {
+			sum += v;
+		}
+	};
+
+	//每个测量至少调用约total_ops次槽,使得小规模时的计时也足够长
+	std::size_t iterationsFor(std::size_t slots, std::size_t total_ops) {
+		std::size_t n = total_ops / (slots == 0 ? 1 : slots);
+		return n == 0 ? 1 : n;
+	}
+
+	void benchEmit(CsvReporter& report, const std::vector<std::size_t>& sizes, std::size_t total_ops) {
+		CountTime<Clock> timer;
+		for (std::size_t n : sizes) {
+			std::size_t iters = iterationsFor(n, total_ops);
+			SimpleSignal<void(int)> sig;
+			HomogeneousSignal<void(int), Adder> homo;
+			Baseline vec;
+			for (std::size_t i = 0; i != n; ++i) {
+				sig += Adder{ static_cast<int>(i) };
+				homo.connect(Adder{ static_cast<int>(i) });
+				vec.emplace_back(Adder{ static_cast<int>(i) });
+			}
+			report.report("emit", "SimpleSignal", n, iters, timer([&] { sig(1); }, iters), n);
+			report.report("emit", "HomogeneousSignal", n, iters, timer([&] { homo(1); }, iters), n);
+			report.report("emit", "vector<function>", n, iters, timer([&] {
+				for (auto& f : vec) {
+					f(1);
+				}
+			}, iters), n);
+		}
+	}
+
+	void benchChurn(CsvReporter& report, const std::vector<std::size_t>& sizes, std::size_t total_ops) {
+		CountTime<Clock> timer;
+		for (std::size_t n : sizes) {
+			std::size_t iters = iterationsFor(n, total_ops / 10);
+			SimpleSignal<void(int)> sig;
+			std::vector<SimpleSignal<void(int)>::Connection> cons(n);
+			report.report("connect_disconnect", "SimpleSignal", n, iters, timer([&] {
+				for (std::size_t i = 0; i != n; ++i) {
+					cons[i] = sig.connect(Adder{ static_cast<int>(i) });
+				}
+				for (std::size_t i = n; i-- != 0;) {
+					cons[i]->disconnect();
+				}
+			}, iters), n);
+
+			Baseline vec;
+			report.report("connect_disconnect", "vector<function>", n, iters, timer([&] {
+				for (std::size_t i = 0; i != n; ++i) {
+					vec.emplace_back(Adder{ static_cast<int>(i) });
+				}
+				//与通过connection逆序断开相当
+				while (!vec.empty()) {
+					vec.pop_back();
+				}
+			}, iters), n);
+		}
+	}
+
+	void benchDisconnectByValue(CsvReporter& report, const std::vector<std::size_t>& sizes, std::size_t total_ops) {
+		CountTime<Clock> timer;
+		for (std::size_t n : sizes) {
+			if (n > 10000) {
+				continue;	//两者都是O(n^2)
+			}
+			std::size_t iters = iterationsFor(n * n, total_ops);
+			SimpleSignal<void(int)> sig;
+			report.report("disconnect_by_value", "SimpleSignal", n, iters, timer([&] {
+				for (std::size_t i = 0; i != n; ++i) {
+					sig += Adder{ static_cast<int>(i) };
+				}
+				for (std::size_t i = n; i-- != 0;) {
+					sig -= Adder{ static_cast<int>(i) };
+				}
+			}, iters), n);
+
+			Baseline vec;
+			report.report("disconnect_by_value", "vector<function>", n, iters, timer([&] {
+				for (std::size_t i = 0; i != n; ++i) {
+					vec.emplace_back(Adder{ static_cast<int>(i) });
+				}
+				for (std::size_t i = n; i-- != 0;) {
+					Adder key{ static_cast<int>(i) };
+					vec.erase(std::remove_if(vec.begin(), vec.end(), [&key](const std::function<void(int)>& f) {
+						auto ptr = f.target<Adder>();
+						return ptr != nullptr && *ptr == key;
+					}), vec.end());
+				}
+			}, iters), n);
+		}
+	}
+
+	void benchLockedCollect(CsvReporter& report, const std::vector<std::size_t>& sizes, std::size_t total_ops) {
+		CountTime<Clock> timer;
+		auto locked = [](auto first, auto last, auto& sig) {
+			auto beg = makeLockedIter(first, sig);
+			auto end = makeLockedIter(last, sig);
+			for (; beg != end; ++beg) {
+				if (beg) {
+					*beg;
+				}
+			}
+		};
+		for (std::size_t n : sizes) {
+			std::size_t iters = iterationsFor(n, total_ops);
+			SimpleSignal<void(int)> sig;
+			Baseline vec;
+			for (std::size_t i = 0; i != n; ++i) {
+				sig += Adder{ static_cast<int>(i) };
+				vec.emplace_back(Adder{ static_cast<int>(i) });
+			}
+			report.report("collect_locked", "SimpleSignal", n, iters, timer([&] { sig.collect(locked, 1); }, iters), n);
+			report.report("collect_locked", "SimpleSignal_guarded", n, iters, timer([&] { sig.emit_guarded(1); }, iters), n);
+			//vector没有防止重入的机制,以每次调用前后设置标志来模拟
+			std::vector<char> busy(n);
+			report.report("collect_locked", "vector<function>", n, iters, timer([&] {
+				for (std::size_t i = 0; i != n; ++i) {
+					if (!busy[i]) {
+						busy[i] = 1;
+						vec[i](1);
+						busy[i] = 0;
+					}
+				}
+			}, iters), n);
+		}
+	}
+
+	void benchWeakMemFun(CsvReporter& report, const std::vector<std::size_t>& sizes, std::size_t total_ops) {
+		CountTime<Clock> timer;
+		for (std::size_t n : sizes) {
+			std::size_t iters = iterationsFor(n, total_ops);
+			std::vector<std::shared_ptr<Target>> objs;
+			SimpleSignal<void(int)> sig;
+			Baseline vec;
+			for (std::size_t i = 0; i != n; ++i) {
+				objs.push_back(std::make_shared<Target>());
+				sig.connect(objs.back(), &Target::add);
+				std::weak_ptr<Target> weak = objs.back();
+				vec.emplace_back([weak](int v) {
+					if (auto obj = weak.lock()) {
+						obj->add(v);
+					}
+				});
+			}
+			report.report("memfun_weak_ptr", "SimpleSignal", n, iters, timer([&] { sig(1); }, iters), n);
+			report.report("memfun_weak_ptr", "vector<function>", n, iters, timer([&] {
+				for (auto& f : vec) {
+					f(1);
+				}
+			}, iters), n);
+		}
+	}
+
+	//n个超时,其中九成在到期前取消,其余的全部触发
+	void benchTimers(CsvReporter& report, const std::vector<std::size_t>& sizes, std::size_t total_ops) {
+		CountTime<Clock> timer;
+		for (std::size_t n : sizes) {
+			std::size_t iters = iterationsFor(n, total_ops / 10);
+			Clock::time_point origin{};
+			std::uint64_t elapsed = 0;
+			TimingWheel wheel(1ms, origin);
+			std::vector<TimerId> ids(n);
+			report.report("timeout_cancel", "TimingWheel", n, iters, timer([&] {
+				for (std::size_t i = 0; i != n; ++i) {
+					ids[i] = wheel.schedule_at(origin + std::chrono::milliseconds(elapsed + 1 + i % 5000), [] { sink_value += 1; });
+				}
+				for (std::size_t i = 0; i != n; ++i) {
+					if (i % 10 != 0) {
+						wheel.cancel(ids[i]);
+					}
+				}
+				elapsed += 5000;
+				wheel.advance(origin + std::chrono::milliseconds(elapsed));
+			}, iters), n);
+
+			using Deadlines = std::multimap<std::uint64_t, std::function<void()>>;
+			Deadlines deadlines;
+			std::vector<Deadlines::iterator> pos(n);
+			elapsed = 0;
+			report.report("timeout_cancel", "multimap<function>", n, iters, timer([&] {
+				for (std::size_t i = 0; i != n; ++i) {
+					pos[i] = deadlines.emplace(elapsed + 1 + i % 5000, [] { sink_value += 1; });
+				}
+				for (std::size_t i = 0; i != n; ++i) {
+					if (i % 10 != 0) {
+						deadlines.erase(pos[i]);
+					}
+				}
+				elapsed += 5000;
+				auto last = deadlines.upper_bound(elapsed);
+				for (auto iter = deadlines.begin(); iter != last; ++iter) {
+					iter->second();
+				}
+				deadlines.erase(deadlines.begin(), last);
+			}, iters), n);
+		}
+	}
+
+	//五个操作:融合成一个槽,与每一步都经过一个信号相比
+	void benchOperatorChain(CsvReporter& report, std::size_t total_ops) {
+		CountTime<Clock> timer;
+		std::size_t iters = total_ops;
+		auto keep = [](int v) { return v >= 0; };
+		auto inc = [](int v) { return v + 1; };
+		auto sink = [](int v) { sink_value += v; };
+
+		SimpleSignal<void(int)> src;
+		pipe(src, filter(keep) | map(inc) | filter(keep) | map(inc) | map(inc), sink);
+		report.report("operator_chain", "fused", 5, iters, timer([&] { src(1); }, iters), 1);
+
+		SimpleSignal<void(int)> hops[6];
+		hops[0] += [&](int v) { if (keep(v)) hops[1](v); };
+		hops[1] += [&](int v) { hops[2](inc(v)); };
+		hops[2] += [&](int v) { if (keep(v)) hops[3](v); };
+		hops[3] += [&](int v) { hops[4](inc(v)); };
+		hops[4] += [&](int v) { hops[5](inc(v)); };
+		hops[5] += sink;
+		report.report("operator_chain", "signal_per_hop", 5, iters, timer([&] { hops[0](1); }, iters), 1);
+	}
+}
+
+int main(int argc, char** argv) {
+	bool quick = false;
+	std::ofstream file;
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--quick") == 0) {
+			quick = true;
+		} else {
+			file.open(argv[i]);
+			if (!file) {
+				std::cerr << "can not open " << argv[i] << '\n';
+				return 1;
+			}
+		}
+	}
+	std::vector<std::size_t> sizes{ 1, 10, 100, 1000, 10000, 100000 };
+	std::size_t total_ops = 2000000;
+	if (quick) {
+		sizes = { 1, 10, 100, 1000 };
+		total_ops = 20000;
+	}
+	CsvReporter report(file.is_open() ? static_cast<std::ostream&>(file) : std::cout);
+	benchEmit(report, sizes, total_ops);
+	benchChurn(report, sizes, total_ops);
+	benchDisconnectByValue(report, sizes, total_ops);
+	benchLockedCollect(report, sizes, total_ops);
+	benchWeakMemFun(report, sizes, total_ops);
+	benchTimers(report, sizes, total_ops);
+	benchOperatorChain(report, total_ops);
+	doNotOptimize(sink_value);
+	return 0;
+}
@@ -1,6 +1,8 @@
 ﻿#pragma once
-#include <Talg/call.h>
-
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
 #include <Talg/basic_macro_impl.h>
 namespace Talg {
 
@@ -9,42 +11,73 @@ namespace Talg {
 				used for count time of one function.
 		\tparam Clock clock type,which should meets the requirements of Concept TrivialClock
 	*/
-	template<class Clock>
+	template<class Clock = std::chrono::steady_clock>
 	struct CountTime {
 		/*
 			\brief	用于测量单个函数的迭代若干次的执行时间,
 					并且可以在计时开始前进行初始化准备.
 					measure the run time of one function which be called iter_cnt times.
-			\param	\func:		被测函数 
-								the function be called. 
-					\iter_cnt:	调用次数 
+			\param	\func:		被测函数
+								the function be called.
+					\iter_cnt:	调用次数
 								count of calls.
-					\fixtures:	用于预处理工作的函数列 
+					\fixtures:	用于预处理工作的函数列
 								a list of functions that be called before time countting.
 			\return	the duration of the clock.
 		*/
 		template<class Func,class...Fixture>
-		static auto operator()(Func&& func,size_t iter_cnt,Fixture&&...fixtures) {
-			forEach(forward_m(fixtures)...);
+		auto operator()(Func&& func,size_t iter_cnt,Fixture&&...fixtures)const {
+			using expand = int[];
+			(void)expand{ 0, ((void)forward_m(fixtures)(), 0)... };
 			auto prev = Clock::now();
-			forward_m(func)();
+			for (size_t i = 0; i != iter_cnt; ++i) {
+				func();
+			}
 			auto time = Clock::now() - prev;
 			return time;
 		}
 	};
 
+	/*!
+		\brief	阻止编译器把val的计算当作无用代码消除.
+				keep the value observable so that the computation is not optimized away.
+	*/
+	inline const void* volatile& doNotOptimizeSink() {
+		static const void* volatile sink = nullptr;
+		return sink;
+	}
+	template<class T>
+	void doNotOptimize(const T& val) {
+	#if defined(__GNUC__)
+		asm volatile("" : : "g"(&val) : "memory");
+	#else
+		doNotOptimizeSink() = &val;
+	#endif
+	}
 
-
-
-
-
-
-
-
-
-
+	/*!
+		\brief	以CSV格式输出benchmark的结果,每个测量一行:
+				case,impl,param,iterations,total_ns,ns_per_op
+				其中param是测量的规模(如槽数),ns_per_op = total_ns / (iterations*ops_per_iter).
+				print the results as CSV so that they can be compared between releases.
+	*/
+	class CsvReporter {
+		std::ostream& out_;
+	public:
+		explicit CsvReporter(std::ostream& out)
+			:out_(out)
+		{
+			out_ << "case,impl,param,iterations,total_ns,ns_per_op\n";
+		}
+		template<class Rep,class Period>
+		void report(const std::string& name, const std::string& impl, std::size_t param,
+			std::size_t iterations, std::chrono::duration<Rep, Period> time, std::size_t ops_per_iter = 1) {
+			auto ns = std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(time).count();
+			double ops = static_cast<double>(iterations) * static_cast<double>(ops_per_iter);
+			out_ << name << ',' << impl << ',' << param << ',' << iterations << ','
+				<< static_cast<long long>(ns) << ',' << (ops > 0 ? ns / ops : 0.0) << '\n';
+		}
+	};
 
 }
 #include <Talg/undef_macro.h>
-
-
@@ -0,0 +1,134 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include "basic_macro_impl.h"
+
+namespace Talg{
+
+/*
+	\brief	有界的多生产者多消费者无锁队列(Vyukov).
+			每个格子带有一个序号,生产者与消费者各自以CAS推进位置,
+			格子的序号表明其当前是可写还是可读,因此不需要额外的锁.
+	\param	T 元素类型,要求可以无异常移动
+	\note	容量会向上取整为2的幂.队列本身不会等待,满或空时立即返回false.
+*/
+template<class T>
+class BoundedQueue {
+	static_assert(std::is_nothrow_move_constructible<T>::value, "T must be nothrow move constructible.");
+	struct Cell {
+		std::atomic<std::size_t> seq;
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+		T& value()noexcept {
+			return *reinterpret_cast<T*>(&storage);
+		}
+	};
+	std::unique_ptr<Cell[]> cells_;
+	std::size_t mask_;
+	char pad0_[64];		//生产者与消费者的位置放在不同的缓存行
+	std::atomic<std::size_t> enqueue_pos_{0};
+	char pad1_[64];
+	std::atomic<std::size_t> dequeue_pos_{0};
+	char pad2_[64];
+
+	static std::size_t roundUp(std::size_t n)noexcept {
+		std::size_t res = 2;
+		while (res < n) {
+			res <<= 1;
+		}
+		return res;
+	}
+public:
+	explicit BoundedQueue(std::size_t capacity)
+		:cells_(new Cell[roundUp(capacity)]), mask_(roundUp(capacity) - 1)
+	{
+		for (std::size_t i = 0; i <= mask_; ++i) {
+			cells_[i].seq.store(i, std::memory_order_relaxed);
+		}
+	}
+	BoundedQueue(const BoundedQueue&) = delete;
+	BoundedQueue& operator=(const BoundedQueue&) = delete;
+	~BoundedQueue() {
+		while (try_pop([](T&&) {}));
+	}
+
+	/*
+		\brief	尝试入队
+		\return	队列已满时返回false,此时value保持不变
+	*/
+	bool try_push(T& value)noexcept {
+		Cell* cell;
+		std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+		for (;;) {
+			cell = &cells_[pos & mask_];
+			std::size_t seq = cell->seq.load(std::memory_order_acquire);
+			auto dif = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+			if (dif == 0) {
+				if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			} else if (dif < 0) {
+				return false;
+			} else {
+				pos = enqueue_pos_.load(std::memory_order_relaxed);
+			}
+		}
+		::new (static_cast<void*>(&cell->storage)) T(std::move(value));
+		cell->seq.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+	bool try_push(T&& value)noexcept {
+		return try_push(value);
+	}
+
+	/*
+		\brief	尝试出队,成功时以右值将元素交给consumer
+		\note	consumer在格子归还之后才被调用,因此可以在其中做耗时的事情.
+	*/
+	template<class F>
+	bool try_pop(F&& consumer) {
+		Cell* cell;
+		std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+		for (;;) {
+			cell = &cells_[pos & mask_];
+			std::size_t seq = cell->seq.load(std::memory_order_acquire);
+			auto dif = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+			if (dif == 0) {
+				if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			} else if (dif < 0) {
+				return false;
+			} else {
+				pos = dequeue_pos_.load(std::memory_order_relaxed);
+			}
+		}
+		T value(std::move(cell->value()));
+		cell->value().~T();
+		cell->seq.store(pos + mask_ + 1, std::memory_order_release);
+		forward_m(consumer)(std::move(value));
+		return true;
+	}
+
+	std::size_t capacity()const noexcept {
+		return mask_ + 1;
+	}
+	/*
+		\brief	近似的元素个数,并发修改时只能作为参考
+	*/
+	std::size_t size_approx()const noexcept {
+		std::size_t tail = enqueue_pos_.load(std::memory_order_relaxed);
+		std::size_t head = dequeue_pos_.load(std::memory_order_relaxed);
+		return tail > head ? tail - head : 0;
+	}
+	bool empty_approx()const noexcept {
+		return size_approx() == 0;
+	}
+};
+
+}//namespace Talg
+
+#include "undef_macro.h"
@@ -0,0 +1,394 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <cassert>
+#include <type_traits>
+#include "basic_macro_impl.h"
+
+namespace Talg{
+
+/*
+	\brief	接口与SingleList一致的单向链表,但节点取自按块连续分配的节点池,
+			释放的节点挂入侵入式的空闲链表以供复用.
+			因此在稳定状态下插入不需要分配内存,并且按插入顺序遍历时节点基本上是相邻的.
+	\param	T 元素类型,Allocator 用于分配节点块
+	\note	节点地址在其生存期内不变,插入删除不会使其他节点的迭代器失效.
+			每块容纳chunk_size个节点,块只在析构时才归还.
+			被删除的节点在被复用之前仍保留着指向原后继的next.
+			每个节点有固定的编号以及删除时递增的代数,可以据此得到不持有内存的弱引用Handle.
+*/
+template<class T,class Allocator = std::allocator<T>>
+class ChunkList {
+public:
+	static constexpr std::size_t chunk_size = 64;
+private:
+	struct NodeBase {
+		NodeBase* next = nullptr;
+	};
+	struct Node :NodeBase {
+		std::uint32_t gen = 0;		//每次删除递增
+		std::uint32_t index = 0;	//在所有块中的编号,分配块时确定
+		typename std::aligned_storage<
+			(sizeof(T) > sizeof(void*) ? sizeof(T) : sizeof(void*)),
+			(alignof(T) > alignof(void*) ? alignof(T) : alignof(void*))
+		>::type storage;
+		T& value()noexcept {
+			return *reinterpret_cast<T*>(&storage);
+		}
+		//空闲链表的链接保存在已经析构的元素的存储中,从而不改动next:
+		//正在遍历的迭代器即使停在刚被删除的节点上,也仍然可以前进到原来的后继.
+		Node*& freeLink()noexcept {
+			return *reinterpret_cast<Node**>(&storage);
+		}
+	};
+	struct Chunk {
+		typename std::aligned_storage<sizeof(Node), alignof(Node)>::type nodes[chunk_size];
+		Node* at(std::size_t id)noexcept {
+			return reinterpret_cast<Node*>(&nodes[id]);
+		}
+	};
+	using ChunkAlloc = typename std::allocator_traits<Allocator>::template rebind_alloc<Chunk>;
+	using ChunkTraits = std::allocator_traits<ChunkAlloc>;
+
+	template<bool is_const>
+	class Iter {
+		friend class ChunkList;
+		friend class Iter<!is_const>;
+		NodeBase* node_ = nullptr;
+	public:
+		using value_type		= T;
+		using reference			= std::conditional_t<is_const, const T&, T&>;
+		using pointer			= std::conditional_t<is_const, const T*, T*>;
+		using difference_type	= std::ptrdiff_t;
+		using iterator_category = std::forward_iterator_tag;
+
+		Iter()noexcept = default;
+		explicit Iter(NodeBase* node)noexcept :node_(node) {}
+		template<bool other,class = std::enable_if_t<is_const && !other>>
+		Iter(const Iter<other>& rhs)noexcept :node_(rhs.node_) {}
+
+		reference operator*()const noexcept {
+			return static_cast<Node*>(node_)->value();
+		}
+		pointer operator->()const noexcept {
+			return std::addressof(**this);
+		}
+		Iter& operator++()noexcept {
+			node_ = node_->next;
+			return *this;
+		}
+		Iter operator++(int)noexcept {
+			Iter old = *this;
+			node_ = node_->next;
+			return old;
+		}
+		friend bool operator==(const Iter& lhs, const Iter& rhs)noexcept {
+			return lhs.node_ == rhs.node_;
+		}
+		friend bool operator!=(const Iter& lhs, const Iter& rhs)noexcept {
+			return lhs.node_ != rhs.node_;
+		}
+	};
+public:
+	using value_type		= T;
+	using allocator_type	= Allocator;
+	using size_type			= std::size_t;
+	using difference_type	= std::ptrdiff_t;
+	using reference			= T&;
+	using const_reference	= const T&;
+	using pointer			= T*;
+	using const_pointer		= const T*;
+	using iterator			= Iter<false>;
+	using const_iterator	= Iter<true>;
+private:
+	NodeBase head_;
+	NodeBase* last_;
+	Node* free_ = nullptr;
+	std::vector<Chunk*> chunks_;
+	std::size_t bump_chunk_ = 0;	//下一个从未使用过的节点所在的块
+	std::size_t bump_pos_ = 0;		//及其在块内的位置
+	ChunkAlloc alloc_;
+
+	Node* allocNode() {
+		if (free_ != nullptr) {
+			Node* node = free_;
+			free_ = node->freeLink();
+			return node;
+		}
+		if (bump_pos_ == chunk_size) {
+			++bump_chunk_;
+			bump_pos_ = 0;
+		}
+		if (bump_chunk_ == chunks_.size()) {
+			//先保证push_back不会抛出,避免分配的块泄漏;按倍数增长以免每次都重新分配
+			if (chunks_.size() == chunks_.capacity()) {
+				chunks_.reserve(chunks_.size() * 2 + 1);
+			}
+			Chunk* chunk = ChunkTraits::allocate(alloc_, 1);
+			for (std::size_t i = 0; i != chunk_size; ++i) {
+				Node* node = ::new (static_cast<void*>(chunk->at(i))) Node();
+				node->index = static_cast<std::uint32_t>(chunks_.size()*chunk_size + i);
+			}
+			chunks_.push_back(chunk);
+		}
+		return chunks_[bump_chunk_]->at(bump_pos_++);
+	}
+	void freeNode(Node* node)noexcept {
+		++node->gen;
+		::new (static_cast<void*>(&node->storage)) Node*(free_);
+		free_ = node;
+	}
+	template<class...Ts>
+	NodeBase* insertAfter(NodeBase* pos, Ts&&...args) {
+		Node* node = allocNode();
+		try {
+			::new (static_cast<void*>(&node->storage)) T(std::forward<Ts>(args)...);
+		}
+		catch (...) {
+			freeNode(node);
+			throw;
+		}
+		node->next = pos->next;
+		pos->next = node;
+		if (pos == last_) {
+			last_ = node;
+		}
+		return node;
+	}
+	void destroyAll()noexcept {
+		NodeBase* cur = head_.next;
+		while (cur != nullptr) {
+			NodeBase* next = cur->next;
+			static_cast<Node*>(cur)->value().~T();
+			++static_cast<Node*>(cur)->gen;
+			cur = next;
+		}
+		head_.next = nullptr;
+		last_ = &head_;
+	}
+	void releaseChunks()noexcept {
+		for (Chunk* chunk : chunks_) {
+			ChunkTraits::deallocate(alloc_, chunk, 1);
+		}
+		chunks_.clear();
+		free_ = nullptr;
+		bump_chunk_ = 0;
+		bump_pos_ = 0;
+	}
+	void steal(ChunkList& rhs)noexcept {
+		head_.next = rhs.head_.next;
+		last_ = rhs.last_ == &rhs.head_ ? &head_ : rhs.last_;
+		free_ = rhs.free_;
+		chunks_.swap(rhs.chunks_);
+		bump_chunk_ = rhs.bump_chunk_;
+		bump_pos_ = rhs.bump_pos_;
+		rhs.head_.next = nullptr;
+		rhs.last_ = &rhs.head_;
+		rhs.free_ = nullptr;
+		rhs.bump_chunk_ = 0;
+		rhs.bump_pos_ = 0;
+	}
+	void moveAssign(ChunkList& rhs, std::true_type)noexcept {
+		destroyAll();
+		releaseChunks();
+		alloc_ = std::move(rhs.alloc_);
+		steal(rhs);
+	}
+	void moveAssign(ChunkList& rhs, std::false_type) {
+		if (alloc_ == rhs.alloc_) {
+			destroyAll();
+			releaseChunks();
+			steal(rhs);
+			return;
+		}
+		clear();
+		for (auto& elem : rhs) {
+			emplace_back(std::move(elem));
+		}
+		rhs.clear();
+	}
+public:
+	ChunkList()noexcept(std::is_nothrow_default_constructible<ChunkAlloc>::value)
+		:last_(&head_), alloc_() {}
+	explicit ChunkList(const Allocator& alloc)
+		:last_(&head_), alloc_(alloc) {}
+	ChunkList(ChunkList&& rhs)noexcept
+		:last_(&head_), alloc_(std::move(rhs.alloc_))
+	{
+		steal(rhs);
+	}
+	ChunkList(const ChunkList& rhs)
+		:last_(&head_), alloc_(ChunkTraits::select_on_container_copy_construction(rhs.alloc_))
+	{
+		try {
+			for (auto& elem : rhs) {
+				emplace_back(elem);
+			}
+		}
+		catch (...) {
+			destroyAll();
+			releaseChunks();
+			throw;
+		}
+	}
+	/*
+		\note	propagate_on_container_move_assignment为true或者两个分配器相等时接管rhs的块,
+				否则块只能由原来的分配器释放,因此逐个移动元素.
+	*/
+	ChunkList& operator=(ChunkList&& rhs)
+		noexcept(ChunkTraits::propagate_on_container_move_assignment::value)
+	{
+		if (this != &rhs) {
+			moveAssign(rhs, typename ChunkTraits::propagate_on_container_move_assignment{});
+		}
+		return *this;
+	}
+	ChunkList& operator=(const ChunkList& rhs) {
+		if (this != &rhs) {
+			ChunkList tmp(rhs);
+			*this = std::move(tmp);
+		}
+		return *this;
+	}
+	~ChunkList() {
+		destroyAll();
+		releaseChunks();
+	}
+
+	allocator_type get_allocator()const {
+		return allocator_type(alloc_);
+	}
+
+	iterator before_begin()noexcept { return iterator(&head_); }
+	const_iterator before_begin()const noexcept { return cbefore_begin(); }
+	const_iterator cbefore_begin()const noexcept { return const_iterator(const_cast<NodeBase*>(&head_)); }
+	iterator begin()noexcept { return iterator(head_.next); }
+	const_iterator begin()const noexcept { return cbegin(); }
+	const_iterator cbegin()const noexcept { return const_iterator(head_.next); }
+	iterator end()noexcept { return iterator(); }
+	const_iterator end()const noexcept { return cend(); }
+	const_iterator cend()const noexcept { return const_iterator(); }
+	iterator before_end()noexcept { return iterator(last_); }
+	const_iterator before_end()const noexcept { return cbefore_end(); }
+	const_iterator cbefore_end()const noexcept { return const_iterator(last_); }
+
+	bool empty()const noexcept {
+		return head_.next == nullptr;
+	}
+	reference front()noexcept { return *begin(); }
+	const_reference front()const noexcept { return *begin(); }
+	reference back()noexcept { return *before_end(); }
+	const_reference back()const noexcept { return *before_end(); }
+
+	/*
+		\brief	已经分配的节点总数,包括空闲的节点.
+	*/
+	size_type capacity()const noexcept {
+		return chunks_.size()*chunk_size;
+	}
+
+	template<class...Ts>
+	reference emplace_back(Ts&&...args) {
+		return static_cast<Node*>(insertAfter(last_, std::forward<Ts>(args)...))->value();
+	}
+	template<class...Ts>
+	reference emplace_front(Ts&&...args) {
+		return static_cast<Node*>(insertAfter(&head_, std::forward<Ts>(args)...))->value();
+	}
+	template<class...Ts>
+	iterator emplace_after(const_iterator pos, Ts&&...args) {
+		return iterator(insertAfter(pos.node_, std::forward<Ts>(args)...));
+	}
+	void push_back(const T& value) {
+		emplace_back(value);
+	}
+	void push_back(T&& value) {
+		emplace_back(std::move(value));
+	}
+
+	/*
+		\brief	节点的弱引用,节点被删除或clear之后随之失效.
+		\note	只在产生它的ChunkList存活期间(且未被移动)有意义.
+	*/
+	struct Handle {
+		std::uint32_t index = 0;
+		std::uint32_t gen = 0;
+		friend bool operator==(const Handle& lhs, const Handle& rhs)noexcept {
+			return lhs.index == rhs.index && lhs.gen == rhs.gen;
+		}
+		friend bool operator!=(const Handle& lhs, const Handle& rhs)noexcept {
+			return !(lhs == rhs);
+		}
+	};
+	/*
+		\brief	pos所指的元素的Handle
+		\param	pos 不可以是before_begin或end
+	*/
+	Handle handle(const_iterator pos)const noexcept {
+		const Node* node = static_cast<const Node*>(pos.node_);
+		return Handle{ node->index, node->gen };
+	}
+	/*
+		\brief	取得Handle所指的元素
+		\return	元素已经被删除时返回nullptr
+	*/
+	pointer get(Handle h)noexcept {
+		if (h.index >= capacity()) {
+			return nullptr;
+		}
+		Node* node = chunks_[h.index / chunk_size]->at(h.index % chunk_size);
+		return node->gen == h.gen ? &node->value() : nullptr;
+	}
+	const_pointer get(Handle h)const noexcept {
+		return const_cast<ChunkList*>(this)->get(h);
+	}
+
+	/*
+		\brief	删除pos之后的那个元素
+		\return	被删除元素的下一个元素
+	*/
+	iterator erase_after(const_iterator pos)noexcept {
+		assert(pos.node_ != last_ && !empty());
+		NodeBase* prev = pos.node_;
+		Node* node = static_cast<Node*>(prev->next);
+		prev->next = node->next;
+		if (node == last_) {
+			last_ = prev;
+		}
+		node->value().~T();
+		freeNode(node);
+		return iterator(prev->next);
+	}
+	void pop_front()noexcept {
+		erase_after(cbefore_begin());
+	}
+
+	/*
+		\brief	销毁所有元素,但保留已分配的块以供之后复用.
+	*/
+	void clear()noexcept {
+		destroyAll();
+		free_ = nullptr;
+		bump_chunk_ = 0;
+		bump_pos_ = 0;
+	}
+	template<class UnaryPredicate>
+	void remove_if(UnaryPredicate pred) {
+		auto prev = before_begin();
+		auto iter = begin();
+		while (iter != end()) {
+			if (pred(*iter)) {
+				iter = erase_after(prev);
+			} else {
+				prev = iter++;
+			}
+		}
+	}
+};
+
+}//namespace Talg
+
+#include "undef_macro.h"
@@ -0,0 +1,237 @@
+#pragma once
+#include <cstddef>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "slotlist.h"
+#include "optional.h"
+#include "basic_macro_impl.h"
+
+namespace Talg {
+
+/*
+	\brief	默认的合并方式:只保留最新的参数
+*/
+struct KeepLatest {
+	template<class Event>
+	void operator()(Event& pending, Event&& latest)const {
+		pending = std::move(latest);
+	}
+};
+
+/*
+	\brief	收集被标记为dirty的合并信号,以便在一帧结束时一次性flush.
+	\note	markDirty可以在任何线程中调用;
+			flush_all以及已注册的信号的析构应当在同一个(消费者)线程中进行.
+			flush期间再次emit的信号会在下一次flush_all时处理.
+*/
+class CoalescingRegistry {
+public:
+	using FlushFn = bool(*)(void*);
+private:
+	struct Entry {
+		void* obj;
+		FlushFn flush;
+	};
+	std::mutex mtx_;
+	std::vector<Entry> dirty_;
+	std::vector<Entry> flushing_;		//flush_all中正在处理的项,与dirty_交换以复用内存
+public:
+	CoalescingRegistry() = default;
+	CoalescingRegistry(const CoalescingRegistry&) = delete;
+	CoalescingRegistry& operator=(const CoalescingRegistry&) = delete;
+
+	void markDirty(void* obj, FlushFn flush) {
+		std::lock_guard<std::mutex> lock(mtx_);
+		dirty_.push_back(Entry{ obj, flush });
+	}
+	/*
+		\brief	移除obj的所有项,信号析构时调用
+	*/
+	void remove(void* obj) {
+		std::lock_guard<std::mutex> lock(mtx_);
+		for (auto& e : dirty_) {
+			if (e.obj == obj) {
+				e.obj = nullptr;
+			}
+		}
+		for (auto& e : flushing_) {
+			if (e.obj == obj) {
+				e.obj = nullptr;
+			}
+		}
+	}
+	/*
+		\brief	flush所有dirty的信号
+		\return	实际调用了槽的信号数
+	*/
+	std::size_t flush_all() {
+		{
+			std::lock_guard<std::mutex> lock(mtx_);
+			flushing_.swap(dirty_);
+		}
+		std::size_t count = 0;
+		for (std::size_t i = 0; i != flushing_.size(); ++i) {
+			Entry e = flushing_[i];
+			if (e.obj != nullptr && e.flush(e.obj)) {
+				++count;
+			}
+		}
+		std::lock_guard<std::mutex> lock(mtx_);
+		flushing_.clear();
+		return count;
+	}
+	std::size_t dirty_count() {
+		std::lock_guard<std::mutex> lock(mtx_);
+		return dirty_.size();
+	}
+};
+
+/*
+	\brief	合并多次emit的信号:emit只记录参数并把信号标记为dirty,
+			直到flush时才以记录的参数调用一次内部信号的槽.
+	\param	Signature 必须形如void(Ps...),
+			Reducer 以reducer(pending,std::move(latest))把新的参数合并进尚未flush的参数,
+			两者的类型均为std::tuple<std::decay_t<Ps>...>,默认为KeepLatest,
+			Inner 内部信号的类型
+	\note	emit可以在任何线程中调用,connect/disconnect与flush应当在同一个线程中进行.
+			槽收到的是对参数副本的左值引用.
+*/
+template<class Signature,class Reducer = KeepLatest,class Inner = BasicSignal<Signature>>
+class BasicCoalescingSignal;
+
+template<class...Ps,class Reducer,class Inner>
+class BasicCoalescingSignal<void(Ps...),Reducer,Inner> {
+	using Signal = Inner;
+	using Event = std::tuple<std::decay_t<Ps>...>;
+public:
+	using Connection = typename Signal::Connection;
+	using SharedConnection = typename Signal::SharedConnection;
+private:
+	Signal signal_;
+	Reducer reducer_;
+	CoalescingRegistry* registry_ = nullptr;
+	std::mutex mtx_;
+	optional<Event> pending_;
+	std::size_t coalesced_ = 0;
+
+	template<std::size_t...Is>
+	void invoke(Event& ev, std::index_sequence<Is...>) {
+		signal_(std::get<Is>(ev)...);
+	}
+	static bool flushThunk(void* self) {
+		return static_cast<BasicCoalescingSignal*>(self)->flush();
+	}
+public:
+	explicit BasicCoalescingSignal(Reducer reducer = Reducer())
+		:reducer_(std::move(reducer))
+	{
+
+	}
+	/*
+		\brief	每当信号变为dirty时就登记到registry,registry必须比信号活得更久
+	*/
+	explicit BasicCoalescingSignal(CoalescingRegistry& registry, Reducer reducer = Reducer())
+		:reducer_(std::move(reducer)), registry_(&registry)
+	{
+
+	}
+	BasicCoalescingSignal(const BasicCoalescingSignal&) = delete;
+	BasicCoalescingSignal& operator=(const BasicCoalescingSignal&) = delete;
+	~BasicCoalescingSignal() {
+		if (registry_ != nullptr) {
+			registry_->remove(this);
+		}
+	}
+
+	template<class...Ts>
+	decltype(auto) connect(Ts&&...func) {
+		return signal_.connect(forward_m(func)...);
+	}
+	template<class F>
+	void disconnect(F&& func) {
+		signal_.disconnect(forward_m(func));
+	}
+	template<class F>
+	void disconnect_one(F&& func) {
+		signal_.disconnect_one(forward_m(func));
+	}
+	void disconnect_all() {
+		signal_.disconnect_all();
+	}
+	bool empty()const noexcept {
+		return signal_.empty();
+	}
+
+	/*
+		\brief	记录参数,已经有尚未flush的参数时以Reducer合并
+	*/
+	template<class...Ts>
+	void emit(Ts&&...args) {
+		Event ev(forward_m(args)...);
+		bool became_dirty = false;
+		{
+			std::lock_guard<std::mutex> lock(mtx_);
+			if (pending_) {
+				reducer_(*pending_, std::move(ev));
+				++coalesced_;
+			} else {
+				pending_.emplace(std::move(ev));
+				became_dirty = true;
+			}
+		}
+		if (became_dirty && registry_ != nullptr) {
+			registry_->markDirty(this, &flushThunk);
+		}
+	}
+	template<class...Ts>
+	void operator()(Ts&&...args) {
+		emit(forward_m(args)...);
+	}
+
+	/*
+		\brief	以合并后的参数调用一次所有的槽
+		\return	没有尚未flush的参数时返回false
+		\note	槽中再次emit的参数留待下一次flush.
+	*/
+	bool flush() {
+		optional<Event> ev;
+		{
+			std::lock_guard<std::mutex> lock(mtx_);
+			if (!pending_) {
+				return false;
+			}
+			ev.emplace(std::move(*pending_));
+			pending_ = nullopt;
+		}
+		invoke(*ev, std::index_sequence_for<Ps...>{});
+		return true;
+	}
+	/*
+		\brief	丢弃尚未flush的参数
+	*/
+	void discard() {
+		std::lock_guard<std::mutex> lock(mtx_);
+		pending_ = nullopt;
+	}
+	bool dirty() {
+		std::lock_guard<std::mutex> lock(mtx_);
+		return static_cast<bool>(pending_);
+	}
+	/*
+		\brief	被合并掉的emit的次数
+	*/
+	std::size_t coalesced() {
+		std::lock_guard<std::mutex> lock(mtx_);
+		return coalesced_;
+	}
+};
+
+template<class...Ts>
+using CoalescingSignal = SignalWrapper<BasicCoalescingSignal, Ts...>;
+
+}//namespace Talg
+
+#include "undef_macro.h"
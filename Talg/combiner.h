@@ -0,0 +1,214 @@
+#pragma once
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include "optional.h"
+#include "basic_macro_impl.h"
+
+namespace Talg {
+
+/*
+	\brief	常用的结果组合器,用于BasicSignal::collect等,
+			协议同DefaultResCombiner:以(first,last,sig)调用,
+			迭代器解引用时才真正调用槽,因此一旦结果已经确定,
+			短路的组合器就不再调用剩下的槽.
+	\note	除FirstNonEmpty与CollectInto之外,各组合器还提供init/fold/merge,
+			可以用于collect_parallel(此时不会短路).
+*/
+
+/*
+	\brief	返回第一个可以转换为true的结果(如非空的optional或指针),之后的槽不再调用.
+	\return	没有这样的结果时返回值初始化的对象
+*/
+struct FirstNonEmpty {
+	template<class Iter,class Signal>
+	auto operator()(Iter first, Iter last, const Signal&)const {
+		using Res = std::decay_t<decltype(*first)>;
+		for (; first != last; ++first) {
+			if (!first) {
+				continue;
+			}
+			if (static_cast<bool>(*first)) {
+				return Res(*first);
+			}
+		}
+		return Res();
+	}
+};
+
+/*
+	\brief	有一个结果为true时即返回true,没有槽时返回false
+*/
+struct AnyTrue {
+	static constexpr bool is_associative = true;
+	template<class Iter,class Signal>
+	bool operator()(Iter first, Iter last, const Signal&)const {
+		for (; first != last; ++first) {
+			if (first && static_cast<bool>(*first)) {
+				return true;
+			}
+		}
+		return false;
+	}
+	bool init()const noexcept {
+		return false;
+	}
+	template<class T>
+	bool fold(bool acc, T&& res)const {
+		return acc || static_cast<bool>(res);
+	}
+	bool merge(bool lhs, bool rhs)const noexcept {
+		return lhs || rhs;
+	}
+};
+
+/*
+	\brief	有一个结果为false时即返回false(否决),没有槽时返回true
+*/
+struct AllTrue {
+	static constexpr bool is_associative = true;
+	template<class Iter,class Signal>
+	bool operator()(Iter first, Iter last, const Signal&)const {
+		for (; first != last; ++first) {
+			if (first && !static_cast<bool>(*first)) {
+				return false;
+			}
+		}
+		return true;
+	}
+	bool init()const noexcept {
+		return true;
+	}
+	template<class T>
+	bool fold(bool acc, T&& res)const {
+		return acc && static_cast<bool>(res);
+	}
+	bool merge(bool lhs, bool rhs)const noexcept {
+		return lhs && rhs;
+	}
+};
+
+/*
+	\brief	按Compare选出最靠前的结果,MinOf<T,std::greater<T>>即为最大值
+	\return	optional<T>,没有槽时为空
+*/
+template<class T,class Compare = std::less<T>>
+struct MinOf {
+	static constexpr bool is_associative = true;
+	Compare comp;
+
+	MinOf() = default;
+	explicit MinOf(Compare c) :comp(std::move(c)) {}
+
+	template<class Iter,class Signal>
+	optional<T> operator()(Iter first, Iter last, const Signal&) {
+		optional<T> res;
+		for (; first != last; ++first) {
+			if (first) {
+				res = fold(std::move(res), *first);
+			}
+		}
+		return res;
+	}
+	optional<T> init()const {
+		return optional<T>();
+	}
+	template<class U>
+	optional<T> fold(optional<T> acc, U&& res) {
+		if (!acc || comp(res, *acc)) {
+			acc = T(forward_m(res));
+		}
+		return acc;
+	}
+	optional<T> merge(optional<T> lhs, optional<T> rhs) {
+		if (!lhs) {
+			return rhs;
+		}
+		if (rhs && comp(*rhs, *lhs)) {
+			return rhs;
+		}
+		return lhs;
+	}
+};
+
+template<class T,class Compare = std::greater<T>>
+using MaxOf = MinOf<T, Compare>;
+
+/*
+	\brief	以operator+累加所有结果
+	\param	T 累加的类型,初值为构造时给出的值(默认为值初始化)
+*/
+template<class T>
+struct Sum {
+	static constexpr bool is_associative = true;
+	T zero;
+
+	Sum() :zero() {}
+	explicit Sum(T init_val) :zero(std::move(init_val)) {}
+
+	template<class Iter,class Signal>
+	T operator()(Iter first, Iter last, const Signal&)const {
+		T res = zero;
+		for (; first != last; ++first) {
+			if (first) {
+				res = std::move(res) + *first;
+			}
+		}
+		return res;
+	}
+	T init()const {
+		return zero;
+	}
+	template<class U>
+	T fold(T acc, U&& res)const {
+		return std::move(acc) + forward_m(res);
+	}
+	T merge(T lhs, T rhs)const {
+		return std::move(lhs) + std::move(rhs);
+	}
+};
+
+/*
+	\brief	把结果依次写入调用者提供的缓冲区[out,out_end),缓冲区写满之后不再调用剩下的槽.
+	\param	bounded 为false时不检查out_end,此时Out只需要是输出迭代器(如back_inserter)
+	\return	写入的最后一个结果之后的位置
+*/
+template<class Out,bool bounded = true>
+struct CollectInto {
+	Out out;
+	Out out_end;
+
+	template<class Iter,class Signal>
+	Out operator()(Iter first, Iter last, const Signal&) {
+		for (; first != last; ++first) {
+			if (isFull(std::integral_constant<bool, bounded>{})) {
+				break;
+			}
+			if (first) {
+				*out = *first;
+				++out;
+			}
+		}
+		return out;
+	}
+private:
+	bool isFull(std::true_type)const {
+		return out == out_end;
+	}
+	bool isFull(std::false_type)const noexcept {
+		return false;
+	}
+};
+
+template<class Out>
+CollectInto<Out> collectInto(Out out, Out out_end) {
+	return CollectInto<Out>{ out, out_end };
+}
+template<class Out>
+CollectInto<Out, false> collectInto(Out out) {
+	return CollectInto<Out, false>{ out, out };
+}
+
+}//namespace Talg
+
+#include "undef_macro.h"
@@ -0,0 +1,241 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include "slotlist.h"
+#include "epoch_domain.h"
+#include "basic_macro_impl.h"
+
+namespace Talg {
+
+/*
+	\brief	可以在多个线程中同时emit的信号.
+			emit时只读取当前发布的槽快照(不可变的vector),不加任何锁;
+			connect/disconnect在写者锁内复制出新快照并原子地发布,
+			旧快照及被移除的槽交由EpochDomain在宽限期之后回收.
+	\param	Signature 形如R(Ps...),Functor 槽的函数对象类型
+	\note	disconnect返回之后,已经开始的emit仍然可能调用到被移除的槽(RCU的固有语义),
+			但之后开始的emit不会再看到它.槽会被多个线程同时调用,必须自行保证线程安全.
+*/
+template<class Signature,class Functor=EqualableFunction<Signature>>
+class BasicConcurrentSignal;
+
+template<class R,class...Ps,class Functor>
+class BasicConcurrentSignal<R(Ps...),Functor> {
+public:
+	struct SlotType :Functor {
+		using Base = Functor;
+		std::atomic<bool> connected{ true };
+		std::atomic<bool> blocked{ false };
+		const std::uint64_t id;
+
+		template<class...Ts>
+		SlotType(std::uint64_t i, Ts&&...args)
+			:Base(forward_m(args)...), id(i)
+		{	}
+		bool is_callable()const noexcept {
+			return connected.load(std::memory_order_relaxed) &&
+				!blocked.load(std::memory_order_relaxed);
+		}
+	};
+	using Snapshot = std::vector<SlotType*>;	//发布之后不再修改
+private:
+	struct Core {
+		std::atomic<const Snapshot*> current;
+		std::mutex writer;
+		std::uint64_t next_id = 0;
+
+		Core() :current(new Snapshot()) {}
+		Core(const Core&) = delete;
+		~Core() {
+			const Snapshot* slots = current.load(std::memory_order_relaxed);
+			for (SlotType* slot : *slots) {
+				delete slot;
+			}
+			delete slots;
+		}
+
+		//precondition: 已经持有writer
+		template<class Pred>
+		std::size_t removeIf(Pred&& pred, bool only_one) {
+			const Snapshot* old = current.load(std::memory_order_relaxed);
+			std::unique_ptr<Snapshot> next(new Snapshot());
+			next->reserve(old->size());
+			std::vector<SlotType*> dead;
+			for (SlotType* slot : *old) {
+				if ((!only_one || dead.empty()) && pred(*slot)) {
+					slot->connected.store(false, std::memory_order_release);
+					dead.push_back(slot);
+				} else {
+					next->push_back(slot);
+				}
+			}
+			if (dead.empty()) {
+				return 0;
+			}
+			publish(next.release());
+			for (SlotType* slot : dead) {
+				EpochDomain::instance().retire(slot);
+			}
+			return dead.size();
+		}
+		//precondition: 已经持有writer
+		void publish(const Snapshot* next) {
+			const Snapshot* old = current.exchange(next, std::memory_order_seq_cst);
+			EpochDomain::instance().retire(old);
+		}
+		//precondition: 已经持有writer
+		SlotType* find(std::uint64_t id)const noexcept {
+			for (SlotType* slot : *current.load(std::memory_order_relaxed)) {
+				if (slot->id == id) {
+					return slot;
+				}
+			}
+			return nullptr;
+		}
+	};
+	std::shared_ptr<Core> core_;
+public:
+	/*
+		\brief	连接的句柄,只保存槽的id以及信号内部的弱引用,
+				因此在信号销毁之后调用其成员也是安全的(此时什么也不做).
+		\note	提供operator->是为了可以像BasicSignal::Connection那样写con->disconnect().
+	*/
+	class Connection {
+		std::weak_ptr<Core> core_;
+		std::uint64_t id_ = 0;
+
+		template<class F>
+		bool withSlot(F&& func)const {
+			if (auto core = core_.lock()) {
+				std::lock_guard<std::mutex> lock(core->writer);
+				if (SlotType* slot = core->find(id_)) {
+					func(*slot);
+					return true;
+				}
+			}
+			return false;
+		}
+	public:
+		Connection() = default;
+		Connection(const std::shared_ptr<Core>& core, std::uint64_t id)
+			:core_(core), id_(id) {}
+
+		bool disconnect() {
+			if (auto core = core_.lock()) {
+				std::lock_guard<std::mutex> lock(core->writer);
+				auto id = id_;
+				return core->removeIf([id](const SlotType& slot) { return slot.id == id; }, true) != 0;
+			}
+			return false;
+		}
+		void block() {
+			withSlot([](SlotType& slot) { slot.blocked.store(true, std::memory_order_relaxed); });
+		}
+		void unblock() {
+			withSlot([](SlotType& slot) { slot.blocked.store(false, std::memory_order_relaxed); });
+		}
+		bool is_blocked()const {
+			bool res = false;
+			withSlot([&res](SlotType& slot) { res = slot.blocked.load(std::memory_order_relaxed); });
+			return res;
+		}
+		bool is_connected()const {
+			return withSlot([](SlotType&) {});
+		}
+		Connection* operator->()noexcept {
+			return this;
+		}
+	};
+	using SharedConnection = Connection;
+	using DefaultResCombiner = typename DefaultSlotTraits<Functor>::DefaultResCombiner;
+public:
+	BasicConcurrentSignal()
+		:core_(std::make_shared<Core>()) {}
+	BasicConcurrentSignal(const BasicConcurrentSignal&) = delete;
+	BasicConcurrentSignal& operator=(const BasicConcurrentSignal&) = delete;
+
+	template<class...Ts>
+	Connection connect(Ts&&...func) {
+		std::lock_guard<std::mutex> lock(core_->writer);
+		std::unique_ptr<SlotType> slot(new SlotType(++core_->next_id, forward_m(func)...));
+		const Snapshot* old = core_->current.load(std::memory_order_relaxed);
+		std::unique_ptr<Snapshot> next(new Snapshot());
+		next->reserve(old->size() + 1);
+		next->assign(old->begin(), old->end());
+		next->push_back(slot.get());
+		core_->publish(next.release());
+		return Connection(core_, slot.release()->id);
+	}
+
+	/*
+		\brief	以结果组合器调用当前快照中的所有槽,组合器协议与BasicSignal::collect相同.
+		\note	整个调用过程处于同一个读者临界区内,快照在此期间不会被释放.
+	*/
+	template<class ResCombiner,class...Ts>
+	decltype(auto) collect(ResCombiner&& res_collector, Ts&&...args) {
+		EpochDomain::ReadGuard guard;
+		const Snapshot& slots = *core_->current.load(std::memory_order_seq_cst);
+		auto range = makeIndexSlotRange(slots);
+		using Iter = decltype(range.first);
+		using Cache = CacheRes<R>;
+		auto getter = [&args...](Cache& cache, const Iter& iter)->typename Cache::reference_type
+		{
+			if (!cache) {
+				cache.reset(iter, args...);
+			}
+			return cache.get();
+		};
+		Cache cache{};
+		return forward_m(res_collector)(
+			makeSlotIter<R>(range.first, getter, cache),
+			makeSlotIter<R>(range.second, getter, cache),
+			*this
+		);
+	}
+
+	/*
+		\brief	直接调用所有事件,参数以左值的形式传递给每一个槽.
+	*/
+	template<class...Ts>
+	void operator()(Ts&&...args) {
+		EpochDomain::ReadGuard guard;
+		const Snapshot& slots = *core_->current.load(std::memory_order_seq_cst);
+		for (SlotType* slot : slots) {
+			if (slot->is_callable()) {
+				(*slot)(args...);
+			}
+		}
+	}
+	void emit(Ps...args) {
+		(*this)(args...);
+	}
+
+	template<class F>
+	void disconnect_one(F&& func) {
+		std::lock_guard<std::mutex> lock(core_->writer);
+		core_->removeIf([&func](const SlotType& slot) { return slot == func; }, true);
+	}
+	template<class F>
+	void disconnect(F&& func) {
+		std::lock_guard<std::mutex> lock(core_->writer);
+		core_->removeIf([&func](const SlotType& slot) { return slot == func; }, false);
+	}
+	void disconnect_all() {
+		std::lock_guard<std::mutex> lock(core_->writer);
+		core_->removeIf([](const SlotType&) { return true; }, false);
+	}
+	bool empty()const {
+		EpochDomain::ReadGuard guard;
+		return core_->current.load(std::memory_order_seq_cst)->empty();
+	}
+};
+
+template<class...Ts>
+using ConcurrentSignal = SignalWrapper<BasicConcurrentSignal, Ts...>;
+
+}//namespace Talg
+
+#include "undef_macro.h"
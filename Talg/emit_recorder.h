@@ -0,0 +1,460 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "slotlist.h"
+#include "basic_macro_impl.h"
+
+namespace Talg {
+
+/*
+	\brief	读取序列化之后的参数,数据不足时抛出std::out_of_range
+*/
+class ByteReader {
+	const unsigned char* cur_;
+	const unsigned char* end_;
+public:
+	ByteReader(const unsigned char* first, const unsigned char* last) noexcept
+		:cur_(first), end_(last)
+	{
+
+	}
+	void read(void* dest, std::size_t n) {
+		if (static_cast<std::size_t>(end_ - cur_) < n) {
+			throw std::out_of_range("ByteReader");
+		}
+		std::memcpy(dest, cur_, n);
+		cur_ += n;
+	}
+	std::size_t remain()const noexcept {
+		return static_cast<std::size_t>(end_ - cur_);
+	}
+};
+
+/*
+	\brief	参数的序列化方式,默认只支持可平凡复制的非指针类型(按字节复制)以及std::basic_string.
+			其他类型需要特化ArgCodec,提供
+				static void write(std::vector<unsigned char>& out, const T& val);	//追加到out的末尾
+				static T read(ByteReader& in);
+	\note	以本机的字节序保存,录制与回放应当在同一种平台上进行.
+*/
+template<class T,class = void>
+struct ArgCodec {
+	static_assert(std::is_trivially_copyable<T>::value,
+		"ArgCodec must be specialized for types that are not trivially copyable.");
+	//指针的值在回放时已经没有意义
+	static_assert(!std::is_pointer<T>::value && !std::is_member_pointer<T>::value,
+		"ArgCodec must be specialized for pointer types to record what they point to.");
+	static void write(std::vector<unsigned char>& out, const T& val) {
+		auto ptr = reinterpret_cast<const unsigned char*>(&val);
+		out.insert(out.end(), ptr, ptr + sizeof(T));
+	}
+	static T read(ByteReader& in) {
+		T val;
+		in.read(&val, sizeof(T));
+		return val;
+	}
+};
+template<class Ch,class Traits,class Alloc>
+struct ArgCodec<std::basic_string<Ch, Traits, Alloc>> {
+	using String = std::basic_string<Ch, Traits, Alloc>;
+	static void write(std::vector<unsigned char>& out, const String& val) {
+		ArgCodec<std::uint32_t>::write(out, static_cast<std::uint32_t>(val.size()));
+		auto ptr = reinterpret_cast<const unsigned char*>(val.data());
+		out.insert(out.end(), ptr, ptr + val.size() * sizeof(Ch));
+	}
+	static String read(ByteReader& in) {
+		auto len = ArgCodec<std::uint32_t>::read(in);
+		if (in.remain() / sizeof(Ch) < len) {
+			throw std::out_of_range("ArgCodec<basic_string>");
+		}
+		String str(len, Ch());
+		in.read(&str[0], len * sizeof(Ch));
+		return str;
+	}
+};
+
+/*
+	\brief	一条记录的头部,其后紧跟size个字节的参数
+	\param	id 信号的编号,time 自录制开始经过的纳秒数
+*/
+struct EmitRecordHeader {
+	std::uint32_t id;
+	std::uint32_t size;
+	std::int64_t time;
+};
+
+/*
+	\brief	按时间顺序排列的一段录制结果,可以保存到流中以便离线回放
+*/
+class EmitTrace {
+	std::vector<unsigned char> data_;
+	std::size_t count_ = 0;
+public:
+	EmitTrace() = default;
+	EmitTrace(std::vector<unsigned char> data, std::size_t count)
+		:data_(std::move(data)), count_(count)
+	{
+
+	}
+
+	std::size_t size()const noexcept {
+		return count_;
+	}
+	bool empty()const noexcept {
+		return count_ == 0;
+	}
+	std::size_t bytes()const noexcept {
+		return data_.size();
+	}
+
+	/*
+		\brief	依次以(header,ByteReader&)调用func
+	*/
+	template<class F>
+	void for_each(F&& func)const {
+		const unsigned char* cur = data_.data();
+		const unsigned char* end = cur + data_.size();
+		while (static_cast<std::size_t>(end - cur) >= sizeof(EmitRecordHeader)) {
+			EmitRecordHeader head;
+			std::memcpy(&head, cur, sizeof(head));
+			cur += sizeof(head);
+			if (static_cast<std::size_t>(end - cur) < head.size) {
+				throw std::out_of_range("EmitTrace");
+			}
+			ByteReader in(cur, cur + head.size);
+			func(static_cast<const EmitRecordHeader&>(head), in);
+			cur += head.size;
+		}
+	}
+
+	void save(std::ostream& out)const {
+		std::uint64_t head[2] = { count_, data_.size() };
+		out.write(reinterpret_cast<const char*>(head), sizeof(head));
+		out.write(reinterpret_cast<const char*>(data_.data()), static_cast<std::streamsize>(data_.size()));
+	}
+	static EmitTrace load(std::istream& in) {
+		std::uint64_t head[2] = {};
+		in.read(reinterpret_cast<char*>(head), sizeof(head));
+		std::vector<unsigned char> data(static_cast<std::size_t>(head[1]));
+		in.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		if (!in) {
+			throw std::runtime_error("EmitTrace::load: truncated trace");
+		}
+		return EmitTrace(std::move(data), static_cast<std::size_t>(head[0]));
+	}
+};
+
+/*
+	\brief	把emit的参数录制进固定大小的环形缓冲区,写满之后丢弃最旧的记录.
+	\param	Clock 用于记录时间戳
+	\note	record可以在任何线程中调用.单条记录大于整个缓冲区时被丢弃.
+*/
+template<class Clock = std::chrono::steady_clock>
+class BasicEmitRecorder {
+	std::mutex mtx_;
+	std::vector<unsigned char> ring_;
+	std::size_t head_ = 0;				//最旧的记录的位置
+	std::size_t used_ = 0;
+	std::size_t count_ = 0;
+	std::size_t dropped_ = 0;
+	std::vector<unsigned char> scratch_;	//序列化时使用,受mtx_保护
+	typename Clock::time_point start_;
+
+	void put(std::size_t pos, const void* src, std::size_t n) {
+		if (n == 0) {
+			return;
+		}
+		auto first = std::min(n, ring_.size() - pos);
+		std::memcpy(&ring_[pos], src, first);
+		std::memcpy(ring_.data(), static_cast<const unsigned char*>(src) + first, n - first);
+	}
+	void get(std::size_t pos, void* dest, std::size_t n)const {
+		auto first = std::min(n, ring_.size() - pos);
+		std::memcpy(dest, &ring_[pos], first);
+		std::memcpy(static_cast<unsigned char*>(dest) + first, ring_.data(), n - first);
+	}
+	void popOldest() {
+		EmitRecordHeader head;
+		get(head_, &head, sizeof(head));
+		auto len = sizeof(head) + head.size;
+		head_ = (head_ + len) % ring_.size();
+		used_ -= len;
+		--count_;
+		++dropped_;
+	}
+	template<class...Ts>
+	static void encode(std::vector<unsigned char>& out, const Ts&...args) {
+		using expand = int[];
+		(void)expand{ 0, (ArgCodec<Ts>::write(out, args), 0)... };
+	}
+public:
+	explicit BasicEmitRecorder(std::size_t capacity = 1 << 20)
+		:ring_(capacity < sizeof(EmitRecordHeader) ? sizeof(EmitRecordHeader) : capacity),
+		start_(Clock::now())
+	{
+
+	}
+	BasicEmitRecorder(const BasicEmitRecorder&) = delete;
+	BasicEmitRecorder& operator=(const BasicEmitRecorder&) = delete;
+
+	/*
+		\brief	以id记录一次emit的参数
+		\return	缓冲区装不下这条记录时返回false
+	*/
+	template<class...Ts>
+	bool record(std::uint32_t id, const Ts&...args) {
+		auto now = Clock::now();
+		std::lock_guard<std::mutex> lock(mtx_);
+		//start_由clear()在锁内修改,与clear()同时发生的记录计为从0开始
+		auto time = now < start_ ? Clock::duration::zero() : now - start_;
+		scratch_.clear();
+		encode(scratch_, args...);
+		auto len = sizeof(EmitRecordHeader) + scratch_.size();
+		if (len > ring_.size()) {
+			++dropped_;
+			return false;
+		}
+		while (ring_.size() - used_ < len) {
+			popOldest();
+		}
+		EmitRecordHeader head{ id, static_cast<std::uint32_t>(scratch_.size()),
+			static_cast<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count()) };
+		auto pos = (head_ + used_) % ring_.size();
+		put(pos, &head, sizeof(head));
+		put((pos + sizeof(head)) % ring_.size(), scratch_.data(), scratch_.size());
+		used_ += len;
+		++count_;
+		return true;
+	}
+
+	/*
+		\brief	按时间顺序复制出缓冲区中的所有记录
+	*/
+	EmitTrace snapshot() {
+		std::lock_guard<std::mutex> lock(mtx_);
+		std::vector<unsigned char> data(used_);
+		if (used_ != 0) {
+			get(head_, data.data(), used_);
+		}
+		return EmitTrace(std::move(data), count_);
+	}
+	void clear() {
+		std::lock_guard<std::mutex> lock(mtx_);
+		head_ = used_ = count_ = dropped_ = 0;
+		start_ = Clock::now();
+	}
+	std::size_t size() {
+		std::lock_guard<std::mutex> lock(mtx_);
+		return count_;
+	}
+	/*
+		\brief	因缓冲区已满而被覆盖或丢弃的记录数
+	*/
+	std::size_t dropped() {
+		std::lock_guard<std::mutex> lock(mtx_);
+		return dropped_;
+	}
+	std::size_t capacity()const noexcept {
+		return ring_.size();
+	}
+};
+
+using EmitRecorder = BasicEmitRecorder<>;
+
+/*
+	\brief	在每次emit之前把参数录制进recorder的信号,没有attach时与Inner相同.
+	\param	Signature 形如R(Ps...),各个std::decay_t<Ps>都需要有ArgCodec,
+			Inner 内部信号的类型
+	\note	先记录再调用槽,因此槽中引发的emit排在这次emit之后.
+*/
+template<class Signature,class Inner = BasicSignal<Signature>,class Recorder = EmitRecorder>
+class BasicRecordedSignal;
+
+template<class R,class...Ps,class Inner,class Recorder>
+class BasicRecordedSignal<R(Ps...),Inner,Recorder> {
+	using Signal = Inner;
+public:
+	using Connection = typename Signal::Connection;
+	using SharedConnection = typename Signal::SharedConnection;
+private:
+	Signal signal_;
+	Recorder* recorder_ = nullptr;
+	std::uint32_t id_ = 0;
+
+	template<class...Ts>
+	void record(const Ts&...args) {
+		if (recorder_ != nullptr) {
+			recorder_->template record<std::decay_t<Ps>...>(id_, args...);
+		}
+	}
+public:
+	BasicRecordedSignal() = default;
+	BasicRecordedSignal(Recorder& recorder, std::uint32_t id)
+		:recorder_(&recorder), id_(id)
+	{
+
+	}
+
+	/*
+		\brief	开始录制,recorder必须比信号活得更久或者在此之前detach
+	*/
+	void attach(Recorder& recorder, std::uint32_t id)noexcept {
+		recorder_ = &recorder;
+		id_ = id;
+	}
+	void detach()noexcept {
+		recorder_ = nullptr;
+	}
+	bool recording()const noexcept {
+		return recorder_ != nullptr;
+	}
+	std::uint32_t id()const noexcept {
+		return id_;
+	}
+	Signal& inner()noexcept {
+		return signal_;
+	}
+
+	template<class...Ts>
+	decltype(auto) connect(Ts&&...func) {
+		return signal_.connect(forward_m(func)...);
+	}
+	template<class F>
+	void disconnect(F&& func) {
+		signal_.disconnect(forward_m(func));
+	}
+	template<class F>
+	void disconnect_one(F&& func) {
+		signal_.disconnect_one(forward_m(func));
+	}
+	void disconnect_all() {
+		signal_.disconnect_all();
+	}
+	bool empty()const {
+		return signal_.empty();
+	}
+
+	template<class...Ts>
+	decltype(auto) operator()(Ts&&...args) {
+		record(args...);
+		return signal_(forward_m(args)...);
+	}
+	template<class...Ts>
+	decltype(auto) emit(Ts&&...args) {
+		record(args...);
+		return signal_.emit(forward_m(args)...);
+	}
+	template<class Comb,class...Ts>
+	decltype(auto) collect(Comb&& comb, Ts&&...args) {
+		record(args...);
+		return signal_.collect(forward_m(comb), forward_m(args)...);
+	}
+};
+
+template<class...Ts>
+using RecordedSignal = SignalWrapper<BasicRecordedSignal, Ts...>;
+
+/*
+	\brief	回放的速度:recorded 按照记录的时间间隔,max 不等待
+*/
+enum class ReplaySpeed :char {
+	recorded, max
+};
+
+/*
+	\brief	把录制的emit重新发送给新连接的信号
+	\note	没有bind的id被跳过.
+*/
+class EmitReplayer {
+	std::unordered_map<std::uint32_t, std::function<void(ByteReader&)>> handlers_;
+
+	template<class...Ps,class F,std::size_t...Is>
+	static void decodeCall(F& func, ByteReader& in, std::index_sequence<Is...>) {
+		//参数必须按顺序解码,因此先解码到tuple中
+		std::tuple<Ps...> args{ ArgCodec<Ps>::read(in)... };
+		func(std::get<Is>(args)...);
+	}
+	template<class...Ps,class F>
+	void bindImp(std::uint32_t id, F func) {
+		handlers_[id] = [func](ByteReader& in)mutable {
+			decodeCall<Ps...>(func, in, std::index_sequence_for<Ps...>{});
+		};
+	}
+	template<class F>
+	struct BindAs;
+	template<class R,class...Ps>
+	struct BindAs<R(Ps...)> {
+		template<class F>
+		static void apply(EmitReplayer& self, std::uint32_t id, F&& func) {
+			self.bindImp<std::decay_t<Ps>...>(id, forward_m(func));
+		}
+	};
+public:
+	/*
+		\brief	把id的记录发送给sig,sig必须比回放过程活得更久
+	*/
+	template<class R,class...Ps,class SlotTrait>
+	void bind(std::uint32_t id, BasicSignal<R(Ps...), SlotTrait>& sig) {
+		bindImp<std::decay_t<Ps>...>(id, [&sig](auto&...args) { sig(args...); });
+	}
+	template<class R,class...Ps,class Inner,class Recorder>
+	void bind(std::uint32_t id, BasicRecordedSignal<R(Ps...), Inner, Recorder>& sig) {
+		bindImp<std::decay_t<Ps>...>(id, [&sig](auto&...args) { sig(args...); });
+	}
+	/*
+		\brief	以Signature解码id的记录并调用func
+	*/
+	template<class Signature,class F>
+	void bind_as(std::uint32_t id, F&& func) {
+		BindAs<Signature>::apply(*this, id, forward_m(func));
+	}
+	void unbind(std::uint32_t id) {
+		handlers_.erase(id);
+	}
+
+	/*
+		\return	实际回放的记录数
+	*/
+	template<class Clock = std::chrono::steady_clock>
+	std::size_t replay(const EmitTrace& trace, ReplaySpeed speed = ReplaySpeed::max) {
+		std::size_t count = 0;
+		bool first = true;
+		std::int64_t base = 0;
+		auto start = Clock::now();
+		trace.for_each([&](const EmitRecordHeader& head, ByteReader& in) {
+			if (first) {
+				base = head.time;
+				first = false;
+			}
+			auto iter = handlers_.find(head.id);
+			if (iter == handlers_.end()) {
+				return;
+			}
+			if (speed == ReplaySpeed::recorded) {
+				std::this_thread::sleep_until(start + std::chrono::nanoseconds(head.time - base));
+			}
+			iter->second(in);
+			++count;
+		});
+		return count;
+	}
+};
+
+}//namespace Talg
+
+#include "undef_macro.h"
@@ -0,0 +1,164 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include "basic_macro_impl.h"
+
+namespace Talg{
+
+/*
+	\brief	基于epoch的延迟回收(RCU风格).
+			读者进出临界区只写本线程的记录,不加锁;写者发布新版本后将旧版本交给retire,
+			等到所有在发布之前进入临界区的读者都离开之后才真正释放.
+	\note	全局唯一,记录以无锁链表串起来,只增不减,线程退出后可被其他线程复用.
+			临界区可以嵌套,只有最外层的进出才会改写记录.
+*/
+class EpochDomain {
+	struct Record {
+		std::atomic<std::uint64_t> epoch{0};	//0表示不在临界区内
+		std::atomic<bool> used{false};
+		Record* next = nullptr;
+		unsigned depth = 0;						//只由占用该记录的线程访问
+		char pad_[64];							//避免不同线程的记录落在同一缓存行
+	};
+	struct Retired {
+		void* ptr;
+		void (*deleter)(void*);
+		std::uint64_t epoch;
+	};
+	struct ThreadEntry {
+		Record* rec = nullptr;
+		~ThreadEntry() {
+			if (rec != nullptr) {
+				rec->used.store(false, std::memory_order_release);
+			}
+		}
+	};
+
+	std::atomic<Record*> head_{nullptr};
+	std::atomic<std::uint64_t> global_{1};
+	std::mutex retire_mtx_;
+	std::vector<Retired> retired_;
+
+	EpochDomain() = default;
+
+	Record* acquire() {
+		for (Record* rec = head_.load(std::memory_order_acquire); rec != nullptr; rec = rec->next) {
+			bool expect = false;
+			if (!rec->used.load(std::memory_order_relaxed) &&
+				rec->used.compare_exchange_strong(expect, true, std::memory_order_acq_rel)) {
+				return rec;
+			}
+		}
+		Record* rec = new Record();
+		rec->used.store(true, std::memory_order_relaxed);
+		Record* old = head_.load(std::memory_order_relaxed);
+		do {
+			rec->next = old;
+		} while (!head_.compare_exchange_weak(old, rec, std::memory_order_release, std::memory_order_relaxed));
+		return rec;
+	}
+	Record* local() {
+		thread_local ThreadEntry entry;
+		if (entry.rec == nullptr) {
+			entry.rec = acquire();
+		}
+		return entry.rec;
+	}
+	void collectLocked() {
+		std::uint64_t min_active = std::numeric_limits<std::uint64_t>::max();
+		for (Record* rec = head_.load(std::memory_order_acquire); rec != nullptr; rec = rec->next) {
+			std::uint64_t e = rec->epoch.load(std::memory_order_seq_cst);
+			if (e != 0 && e < min_active) {
+				min_active = e;
+			}
+		}
+		auto last = retired_.begin();
+		for (auto iter = retired_.begin(); iter != retired_.end(); ++iter) {
+			if (iter->epoch <= min_active) {
+				iter->deleter(iter->ptr);
+			} else {
+				*last++ = *iter;
+			}
+		}
+		retired_.erase(last, retired_.end());
+	}
+public:
+	EpochDomain(const EpochDomain&) = delete;
+	EpochDomain& operator=(const EpochDomain&) = delete;
+
+	static EpochDomain& instance() {
+		static EpochDomain domain;
+		return domain;
+	}
+
+	/*
+		\brief	读者临界区,在其生存期内通过原子指针读到的版本都不会被释放.
+	*/
+	class ReadGuard {
+		Record* rec;
+	public:
+		explicit ReadGuard(EpochDomain& domain = EpochDomain::instance())
+			:rec(domain.local())
+		{
+			if (rec->depth++ == 0) {
+				rec->epoch.store(domain.global_.load(std::memory_order_acquire), std::memory_order_seq_cst);
+			}
+		}
+		ReadGuard(const ReadGuard&) = delete;
+		ReadGuard& operator=(const ReadGuard&) = delete;
+		~ReadGuard() {
+			if (--rec->depth == 0) {
+				rec->epoch.store(0, std::memory_order_release);
+			}
+		}
+	};
+
+	/*
+		\brief	将已经从共享结构中摘除的对象挂入退休表,待宽限期过后以deleter释放.
+		\param	ptr 已经不可能再被新读者看见的对象,deleter 释放函数
+		\note	调用者必须保证ptr在调用之前已经被替换掉(以seq_cst发布新版本).
+	*/
+	void retire(void* ptr, void (*deleter)(void*)) {
+		std::lock_guard<std::mutex> lock(retire_mtx_);
+		std::uint64_t tag = global_.fetch_add(1, std::memory_order_seq_cst) + 1;
+		retired_.push_back(Retired{ ptr, deleter, tag });
+		collectLocked();
+	}
+	template<class T>
+	void retire(T* ptr) {
+		retire(const_cast<void*>(static_cast<const void*>(ptr)), [](void* p) {
+			delete static_cast<T*>(p);
+		});
+	}
+
+	/*
+		\brief	尝试释放所有宽限期已过的对象.
+	*/
+	void collect() {
+		std::lock_guard<std::mutex> lock(retire_mtx_);
+		collectLocked();
+	}
+	std::size_t pending() {
+		std::lock_guard<std::mutex> lock(retire_mtx_);
+		return retired_.size();
+	}
+
+	~EpochDomain() {
+		for (auto& elem : retired_) {
+			elem.deleter(elem.ptr);
+		}
+		Record* rec = head_.load(std::memory_order_relaxed);
+		while (rec != nullptr) {
+			Record* next = rec->next;
+			delete rec;
+			rec = next;
+		}
+	}
+};
+
+}//namespace Talg
+
+#include "undef_macro.h"
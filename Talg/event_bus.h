@@ -0,0 +1,282 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "ctstring.h"
+#include "find_val.h"
+#include "slotlist.h"
+#include "basic_macro_impl.h"
+
+namespace Talg {
+
+/*
+	\brief	事件总线的主题的基类.
+			主题是一个类型,提供返回ctString的static constexpr函数name(),如
+				struct Click :EventTopic<void(int, int)> {
+					static constexpr auto name() { return makeCtString("click"); }
+				};
+	\param	Signature 该主题的槽的签名
+*/
+template<class Signature>
+struct EventTopic {
+	using signature = Signature;
+};
+
+/*
+	\brief	FNV-1a,编译期与运行期的结果相同
+*/
+constexpr std::uint64_t hashBytes(const char* str, std::size_t len)noexcept {
+	std::uint64_t h = 14695981039346656037ull;
+	for (std::size_t i = 0; i != len; ++i) {
+		h ^= static_cast<unsigned char>(str[i]);
+		h *= 1099511628211ull;
+	}
+	return h;
+}
+template<std::size_t L>
+constexpr std::uint64_t hashBytes(const ctString<L>& str)noexcept {
+	std::uint64_t h = 14695981039346656037ull;
+	for (std::size_t i = 0; i != str.size(); ++i) {
+		h ^= static_cast<unsigned char>(str[i]);
+		h *= 1099511628211ull;
+	}
+	return h;
+}
+
+constexpr std::size_t nextPow2(std::size_t n)noexcept {
+	std::size_t res = 1;
+	while (res < n) {
+		res *= 2;
+	}
+	return res;
+}
+
+/*
+	\brief	以hash-and-displace构造的完美哈希表:
+			先以h%buckets把键分到桶中,再为每个桶选出一个位移disp,
+			使得所有键的mix(h+disp*k)&(slots-1)互不相同.
+	\param	N 键的个数
+	\note	查找得到的只是候选的索引,调用者仍需比较键本身.
+*/
+template<std::size_t N>
+struct PerfectHashTable {
+	static constexpr std::size_t buckets = N / 2 + 1;
+	static constexpr std::size_t slots = nextPow2(2 * N);
+	std::uint64_t disp[buckets] = {};
+	std::size_t index[slots] = {};		//N表示空
+	bool valid = false;
+
+	static constexpr std::uint64_t mix(std::uint64_t x)noexcept {
+		x ^= x >> 30;
+		x *= 0xbf58476d1ce4e5b9ull;
+		x ^= x >> 27;
+		x *= 0x94d049bb133111ebull;
+		x ^= x >> 31;
+		return x;
+	}
+	constexpr std::size_t slotOf(std::uint64_t h, std::uint64_t d)const noexcept {
+		return static_cast<std::size_t>(mix(h + d * 0x9e3779b97f4a7c15ull) & (slots - 1));
+	}
+	/*
+		\return	候选的索引,一定不存在时返回N
+	*/
+	constexpr std::size_t find(std::uint64_t h)const noexcept {
+		return index[slotOf(h, disp[h % buckets])];
+	}
+};
+
+/*
+	\brief	编译期构造完美哈希表
+	\return	键有重复或者找不到合适的位移时valid为false
+*/
+template<std::size_t N>
+constexpr PerfectHashTable<N> makePerfectHash(const std::uint64_t(&keys)[N]) {
+	PerfectHashTable<N> table{};
+	using Table = PerfectHashTable<N>;
+	for (std::size_t i = 0; i != N; ++i) {
+		for (std::size_t j = i + 1; j != N; ++j) {
+			if (keys[i] == keys[j]) {
+				return table;
+			}
+		}
+	}
+	for (std::size_t i = 0; i != Table::slots; ++i) {
+		table.index[i] = N;
+	}
+	std::size_t count[Table::buckets] = {};
+	std::size_t order[Table::buckets] = {};
+	for (std::size_t i = 0; i != N; ++i) {
+		++count[keys[i] % Table::buckets];
+	}
+	//按桶的大小降序放置,大的桶更难找到位移
+	for (std::size_t i = 0; i != Table::buckets; ++i) {
+		order[i] = i;
+	}
+	for (std::size_t i = 0; i != Table::buckets; ++i) {
+		for (std::size_t j = i + 1; j != Table::buckets; ++j) {
+			if (count[order[j]] > count[order[i]]) {
+				auto tmp = order[i];
+				order[i] = order[j];
+				order[j] = tmp;
+			}
+		}
+	}
+	for (std::size_t bi = 0; bi != Table::buckets && count[order[bi]] != 0; ++bi) {
+		std::size_t b = order[bi];
+		bool placed = false;
+		for (std::uint64_t d = 0; d != (1u << 16) && !placed; ++d) {
+			placed = true;
+			std::size_t k = 0;
+			for (; k != N; ++k) {
+				if (keys[k] % Table::buckets != b) {
+					continue;
+				}
+				auto s = table.slotOf(keys[k], d);
+				if (table.index[s] != N) {
+					placed = false;
+					break;
+				}
+				table.index[s] = k;
+			}
+			if (placed) {
+				table.disp[b] = d;
+			} else {
+				//撤销这次尝试中已经放置的键
+				for (std::size_t u = 0; u != k; ++u) {
+					if (keys[u] % Table::buckets == b) {
+						table.index[table.slotOf(keys[u], d)] = N;
+					}
+				}
+			}
+		}
+		if (!placed) {
+			return table;
+		}
+	}
+	table.valid = true;
+	return table;
+}
+
+template<class...Topics>
+constexpr PerfectHashTable<sizeof...(Topics)> makeTopicTable() {
+	const std::uint64_t keys[sizeof...(Topics)] = { hashBytes(Topics::name())... };
+	return makePerfectHash(keys);
+}
+
+/*
+	\brief	以编译期字符串为主题的事件总线,每个主题各有一个SimpleSignal.
+			publish<Topic>在编译期就确定了信号,没有任何查找;
+			以运行期的字符串publish时使用编译期构造的完美哈希表,
+			只需计算一次哈希并比较一次字符串.
+	\param	Topics 主题,见EventTopic,名字不能重复
+*/
+template<class...Topics>
+class EventBus {
+	static_assert(sizeof...(Topics) != 0, "EventBus needs at least one topic.");
+	static_assert(makeTopicTable<Topics...>().valid, "topic names of EventBus must be distinct.");
+	static constexpr std::size_t topic_count = sizeof...(Topics);
+	std::tuple<SimpleSignal<typename Topics::signature>...> signals_;
+
+	template<class Signature,class Args,class = void>
+	struct IsPublishable :std::false_type {};
+	template<class R,class...Ps,class...Ts>
+	struct IsPublishable<R(Ps...), Seq<Ts...>, std::enable_if_t<sizeof...(Ps) == sizeof...(Ts)>>
+		:AndValue<std::is_convertible<Ts&&, Ps>...> {};
+
+	template<class Topic>
+	static bool nameIs(const char* str, std::size_t len) {
+		constexpr auto name = Topic::name();
+		if (len != name.size()) {
+			return false;
+		}
+		for (std::size_t i = 0; i != len; ++i) {
+			if (str[i] != name[i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	template<std::size_t I,class...Ts>
+	static bool publishAtImp(EventBus& self, std::true_type, Ts&&...args) {
+		std::get<I>(self.signals_)(forward_m(args)...);
+		return true;
+	}
+	template<std::size_t I,class...Ts>
+	static bool publishAtImp(EventBus&, std::false_type, Ts&&...) {
+		return false;
+	}
+	template<std::size_t I,class...Ts>
+	static bool publishAt(EventBus& self, Ts&&...args) {
+		using Topic = std::tuple_element_t<I, std::tuple<Topics...>>;
+		using Publishable = IsPublishable<typename Topic::signature, Seq<Ts...>>;
+		return publishAtImp<I>(self, std::integral_constant<bool, Publishable::value>{}, forward_m(args)...);
+	}
+	template<class...Ts,std::size_t...Is>
+	bool publishIndex(std::size_t index, std::index_sequence<Is...>, Ts&&...args) {
+		using Thunk = bool(*)(EventBus&, Ts&&...);
+		static constexpr Thunk thunks[] = { &EventBus::publishAt<Is, Ts...>... };
+		return thunks[index](*this, forward_m(args)...);
+	}
+public:
+	template<class Topic>
+	static constexpr std::size_t index_of()noexcept {
+		return Find_vt<Topic, Seq<Topics...>>::value;
+	}
+	static constexpr std::size_t size()noexcept {
+		return topic_count;
+	}
+
+	/*
+		\return	名为name的主题的索引,没有时返回ctStringBase::npos
+	*/
+	static std::size_t find(const char* name, std::size_t len) {
+		static constexpr auto table = makeTopicTable<Topics...>();
+		static constexpr bool(*matches[])(const char*, std::size_t) = { &EventBus::nameIs<Topics>... };
+		auto index = table.find(hashBytes(name, len));
+		return index != topic_count && matches[index](name, len) ? index : ctStringBase::npos;
+	}
+	static std::size_t find(const std::string& name) {
+		return find(name.data(), name.size());
+	}
+
+	template<class Topic>
+	decltype(auto) get()noexcept {
+		static_assert(index_of<Topic>() != no_index, "Topic is not registered in this EventBus.");
+		return std::get<index_of<Topic>()>(signals_);
+	}
+	template<class Topic>
+	decltype(auto) get()const noexcept {
+		static_assert(index_of<Topic>() != no_index, "Topic is not registered in this EventBus.");
+		return std::get<index_of<Topic>()>(signals_);
+	}
+
+	template<class Topic,class...Fs>
+	decltype(auto) subscribe(Fs&&...func) {
+		return get<Topic>().connect(forward_m(func)...);
+	}
+	template<class Topic,class...Ts>
+	void publish(Ts&&...args) {
+		get<Topic>()(forward_m(args)...);
+	}
+	/*
+		\brief	以运行期的主题名publish
+		\return	没有该主题或者参数与主题的签名不符时返回false
+	*/
+	template<class...Ts>
+	bool publish(const std::string& name, Ts&&...args) {
+		auto index = find(name);
+		if (index == ctStringBase::npos) {
+			return false;
+		}
+		return publishIndex(index, std::index_sequence_for<Topics...>{}, forward_m(args)...);
+	}
+};
+
+}//namespace Talg
+
+#include "undef_macro.h"
@@ -6,6 +6,7 @@
 #include "find_val.h"
 #include "select_type.h"
 #include "has_member.h"
+#include <cassert>
 #include <type_traits>	
 #include <tuple>
 #include <memory>
@@ -161,6 +162,10 @@ struct MemFun
 	MemPtr pmd;	//todo: pmd可以是自由函数,未必需要限制为成员函数指针
 	constexpr MemFun(ObjPtr obj,MemPtr ptr):ptr_(forward_m(obj)),pmd(ptr){}
 
+	constexpr ObjPtr object()const noexcept {
+		return ptr_;
+	}
+
 
 	template<class...Ts>
 	constexpr decltype(auto) operator()(Ts&&...args)const{
@@ -215,6 +220,28 @@ public:
 		assert(func.ptr_ != nullptr);
 	}
 
+	/*
+		\brief	构造时的对象指针,只用于比较及散列,不保证对象仍然存活
+	*/
+	T* object()const noexcept {
+		return func.ptr_;
+	}
+	/*
+		\brief	对象是否已经析构,只读取引用计数,不会像lock()那样修改它
+	*/
+	bool expired()const noexcept {
+		return ptr_.expired();
+	}
+	const std::weak_ptr<T>& tracked()const noexcept {
+		return ptr_;
+	}
+	/*
+		\brief	直接以对象指针调用的版本,调用时对象的存活由使用者保证
+	*/
+	const MemFun<T*, MemPtr, StandarT>& unchecked()const noexcept {
+		return func;
+	}
+
 
 	/*
 		\brief	以ptr及其他参数 调用函数(或成员函数)指针pmd,如Functor一样支持可选参数调用
@@ -0,0 +1,162 @@
+#pragma once
+#include <functional>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include "slotlist.h"
+#include "basic_macro_impl.h"
+
+namespace Talg {
+
+/*
+	\brief	支持分组的信号,调用顺序为:
+				connect_front连接的无组槽,
+				各组按Compare从小到大(组内为connect_group的顺序,connect_group_front的在组首),
+				connect连接的无组槽.
+	\param	Group 组的键,可以是编号也可以是名字,Compare 组的顺序
+	\note	每个组在链表中有一个哨兵节点(不可调用,函数对象为空)标记组的开头,
+			组到哨兵的索引为std::map,因此connect_group是O(log n),
+			而emit时仍是按链表顺序遍历,不需要任何排序.
+			哨兵与普通的槽一样参与State::prev_node_的维护,因此Connection的disconnect依然有效.
+			SlotTrait的Connection必须是std::unique_ptr<State>(如DefaultSlotTraits).
+*/
+template<class Signature,
+		 class Group = int,
+		 class Compare = std::less<Group>,
+		 class SlotTrait = DefaultSlotTraits<EqualableFunction<Signature>>
+>
+class BasicGroupedSignal;
+
+template<class R,class...Ps,class Group,class Compare,class SlotTrait_>
+class BasicGroupedSignal<R(Ps...),Group,Compare,SlotTrait_>
+	:public BasicSignal<R(Ps...),SlotTrait_>
+{
+	using Base = BasicSignal<R(Ps...), SlotTrait_>;
+	using Base::slot_list;
+public:
+	using typename Base::SlotType;
+	using typename Base::State;
+	using typename Base::container;
+	using typename Base::iterator;
+	using typename Base::const_iterator;
+	using typename Base::Connection;
+private:
+	std::unique_ptr<State> back_;					//最后一组之后的哨兵,connect的槽都在其后
+	std::map<Group, State, Compare> groups_;		//各组的哨兵的State
+
+	static bool isSentinel(const SlotType& slot)noexcept {
+		return !static_cast<const typename SlotType::Base&>(slot);
+	}
+	static iterator nodeOf(const State& state)noexcept {
+		return std::next(state.prev_node_);
+	}
+	//在prev之后构造节点,并修正后继的prev_node_
+	template<class...Ts>
+	iterator insertAfter(iterator prev, State* state, Ts&&...args) {
+		iterator iter = slot_list.emplace_after(prev, state, forward_m(args)...);
+		iterator next = std::next(iter);
+		if (next != slot_list.end() && next->state != nullptr) {
+			next->state->prev_node_ = iter;
+		}
+		return iter;
+	}
+	template<class...Fs>
+	Connection connectAfter(iterator prev, Fs&&...func) {
+		auto con = std::make_unique<State>(prev, slot_list);
+		insertAfter(prev, con.get(), makeFunctor<R(Ps...)>(forward_m(func)...));
+		return con;
+	}
+	void makeBack() {
+		back_ = std::make_unique<State>(slot_list.before_end(), slot_list);
+		back_->block();
+		slot_list.emplace_back(back_.get());
+	}
+	//找到组g的哨兵,不存在时创建
+	State& groupOf(const Group& g) {
+		auto iter = groups_.lower_bound(g);
+		if (iter != groups_.end() && !groups_.key_comp()(g, iter->first)) {
+			return iter->second;
+		}
+		State& next = iter == groups_.end() ? *back_ : iter->second;
+		iterator prev = next.prev_node_;
+		auto res = groups_.emplace_hint(iter, std::piecewise_construct,
+			std::forward_as_tuple(g), std::forward_as_tuple(prev, slot_list));
+		State& state = res->second;
+		state.block();
+		insertAfter(prev, &state);
+		return state;
+	}
+public:
+	BasicGroupedSignal() {
+		makeBack();
+	}
+	BasicGroupedSignal(const BasicGroupedSignal&) = delete;
+	BasicGroupedSignal& operator=(const BasicGroupedSignal&) = delete;
+
+	/*
+		\brief	连接到组g的末尾
+	*/
+	template<class...Fs>
+	Connection connect_group(const Group& g, Fs&&...func) {
+		groupOf(g);
+		auto next = groups_.upper_bound(g);
+		State& next_state = next == groups_.end() ? *back_ : next->second;
+		return connectAfter(next_state.prev_node_, forward_m(func)...);
+	}
+	/*
+		\brief	连接到组g的开头
+	*/
+	template<class...Fs>
+	Connection connect_group_front(const Group& g, Fs&&...func) {
+		return connectAfter(nodeOf(groupOf(g)), forward_m(func)...);
+	}
+	/*
+		\brief	作为无组的槽连接到所有槽之前
+	*/
+	template<class...Fs>
+	Connection connect_front(Fs&&...func) {
+		return connectAfter(slot_list.before_begin(), forward_m(func)...);
+	}
+
+	/*
+		\brief	断开组g中的所有槽并删除该组
+	*/
+	void disconnect_group(const Group& g) {
+		auto group = groups_.find(g);
+		if (group == groups_.end()) {
+			return;
+		}
+		iterator prev = group->second.prev_node_;
+		iterator sentinel = std::next(prev);
+		iterator iter = std::next(sentinel);
+		while (iter != slot_list.end() && !isSentinel(*iter)) {
+			iter = slot_list.erase_after(sentinel);
+		}
+		iter = slot_list.erase_after(prev);
+		if (iter != slot_list.end() && iter->state != nullptr) {
+			iter->state->prev_node_ = prev;
+		}
+		groups_.erase(group);
+	}
+	void disconnect_all() {
+		slot_list.clear();
+		groups_.clear();
+		makeBack();
+	}
+	bool empty()const noexcept {
+		for (auto& slot : slot_list) {
+			if (!isSentinel(slot)) {
+				return false;
+			}
+		}
+		return true;
+	}
+};
+
+template<class...Ts>
+using GroupedSignal = SignalWrapper<BasicGroupedSignal, Ts...>;
+
+}//namespace Talg
+
+#include "undef_macro.h"
@@ -0,0 +1,332 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "function_wrapper.h"
+#include "iter_call_cache.h"
+#include "slot_iterator.h"
+#include "basic_macro_impl.h"
+
+namespace Talg {
+
+/*
+	\brief	HomogeneousSignal中的一个槽,函数对象以具体的类型保存
+*/
+template<class Functor>
+struct HomogeneousSlot {
+	Functor func;
+	std::uint64_t id;
+	bool blocked = false;
+	bool removed = false;		//在emit期间被断开,emit结束之后才从vector中删除
+
+	template<class...Ts>
+	HomogeneousSlot(std::uint64_t slot_id, Ts&&...args)
+		:func(forward_m(args)...), id(slot_id)
+	{
+
+	}
+	bool is_callable()const noexcept {
+		return !blocked && !removed;
+	}
+	template<class...Ts>
+	decltype(auto) operator()(Ts&&...args) {
+		return func(forward_m(args)...);
+	}
+};
+
+/*
+	\brief	HomogeneousSignal的连接,以槽的编号找到槽,不可比信号活得更久
+*/
+template<class Signal>
+class HomogeneousConnection {
+	Signal* sig_ = nullptr;
+	std::uint64_t id_ = 0;
+public:
+	HomogeneousConnection() = default;
+	HomogeneousConnection(Signal& sig, std::uint64_t id)noexcept
+		:sig_(&sig), id_(id)
+	{
+
+	}
+	/*
+		\return	槽是否仍然连接着,重复断开或信号已经disconnect_all时返回false
+	*/
+	bool disconnect() {
+		return sig_ != nullptr && sig_->disconnectId(id_);
+	}
+	void block()noexcept {
+		if (auto slot = find()) {
+			slot->blocked = true;
+		}
+	}
+	void unblock()noexcept {
+		if (auto slot = find()) {
+			slot->blocked = false;
+		}
+	}
+	bool is_blocked()const noexcept {
+		auto slot = find();
+		return slot != nullptr && slot->blocked;
+	}
+	bool is_connected()const noexcept {
+		return find() != nullptr;
+	}
+private:
+	auto find()const noexcept {
+		return sig_ == nullptr ? nullptr : sig_->findId(id_);
+	}
+};
+
+/*
+	\brief	所有槽的函数对象类型都相同的信号,槽以具体的类型连续地保存在vector中,
+			emit时直接调用,没有类型擦除带来的间接调用,编译器可以内联槽的调用.
+			例如对许多不同对象的同一个成员函数,见MemberSignal.
+	\param	Signature 信号的签名,Functor 槽的函数对象类型,以信号的参数(左值)调用,
+			disconnect(func)要求Functor可以与func比较相等
+	\note	connect/disconnect/collect的接口与BasicSignal相同,但connect以Functor的构造参数构造槽.
+			emit期间连接的槽不会在这次emit中被调用,emit期间断开的槽只作标记,
+			直到最外层的emit结束之后才真正删除,因此槽的地址在emit期间保持不变.
+			信号不可复制也不可移动,因为连接保存了它的地址.
+*/
+template<class Signature,class Functor>
+class HomogeneousSignal;
+
+template<class R,class...Ps,class Functor>
+class HomogeneousSignal<R(Ps...),Functor> {
+public:
+	using SlotType = HomogeneousSlot<Functor>;
+	using container = std::vector<SlotType>;
+	using Connection = HomogeneousConnection<HomogeneousSignal>;
+	friend Connection;
+private:
+	container slots_;
+	container pending_;			//emit期间连接的槽
+	std::uint64_t next_id_ = 0;
+	std::size_t emit_depth_ = 0;
+	bool dirty_ = false;		//slots_中有removed的槽
+
+	struct EmitScope {
+		HomogeneousSignal& self;
+		explicit EmitScope(HomogeneousSignal& sig)
+			:self(sig)
+		{
+			if (self.emit_depth_ == 0) {
+				self.settle();
+			}
+			++self.emit_depth_;
+		}
+		~EmitScope() {
+			--self.emit_depth_;
+		}
+	};
+	//把emit期间的修改落实到slots_中,只在没有emit时进行
+	void settle() {
+		if (!pending_.empty()) {
+			slots_.insert(slots_.end(),
+				std::make_move_iterator(pending_.begin()), std::make_move_iterator(pending_.end()));
+			pending_.clear();
+		}
+		if (dirty_) {
+			slots_.erase(std::remove_if(slots_.begin(), slots_.end(),
+				[](const SlotType& slot) { return slot.removed; }), slots_.end());
+			dirty_ = false;
+		}
+	}
+	static SlotType* findIn(container& list, std::uint64_t id)noexcept {
+		//编号按连接的顺序递增,删除不改变顺序
+		auto iter = std::lower_bound(list.begin(), list.end(), id,
+			[](const SlotType& slot, std::uint64_t key) { return slot.id < key; });
+		return iter != list.end() && iter->id == id && !iter->removed ? &*iter : nullptr;
+	}
+	SlotType* findId(std::uint64_t id)noexcept {
+		auto slot = findIn(slots_, id);
+		return slot != nullptr ? slot : findIn(pending_, id);
+	}
+	const SlotType* findId(std::uint64_t id)const noexcept {
+		return const_cast<HomogeneousSignal*>(this)->findId(id);
+	}
+	void remove(SlotType& slot) {
+		slot.removed = true;
+		dirty_ = true;
+	}
+	bool disconnectId(std::uint64_t id) {
+		auto slot = findId(id);
+		if (slot == nullptr) {
+			return false;
+		}
+		remove(*slot);
+		if (emit_depth_ == 0) {
+			settle();
+		}
+		return true;
+	}
+	//return 是否删除了槽
+	template<class F>
+	bool removeIn(container& list, const F& func, bool only_one) {
+		bool found = false;
+		for (auto& slot : list) {
+			if (!slot.removed && slot.func == func) {
+				remove(slot);
+				found = true;
+				if (only_one) {
+					break;
+				}
+			}
+		}
+		return found;
+	}
+	template<class F>
+	void disconnectIf(const F& func, bool only_one) {
+		if (!removeIn(slots_, func, only_one) || !only_one) {
+			removeIn(pending_, func, only_one);
+		}
+		if (emit_depth_ == 0) {
+			settle();
+		}
+	}
+public:
+	HomogeneousSignal() = default;
+	HomogeneousSignal(const HomogeneousSignal&) = delete;
+	HomogeneousSignal& operator=(const HomogeneousSignal&) = delete;
+
+	/*
+		\brief	以args构造Functor并追加为最后一个槽
+	*/
+	template<class...Ts>
+	Connection connect(Ts&&...args) {
+		auto id = next_id_++;
+		if (emit_depth_ == 0) {
+			settle();	//collect不会在结束时settle
+			slots_.emplace_back(id, forward_m(args)...);
+		} else {
+			pending_.emplace_back(id, forward_m(args)...);
+		}
+		return Connection(*this, id);
+	}
+	template<class F>
+	void disconnect(const F& func) {
+		disconnectIf(func, false);
+	}
+	template<class F>
+	void disconnect_one(const F& func) {
+		disconnectIf(func, true);
+	}
+	void disconnect_all() {
+		for (auto& slot : slots_) {
+			remove(slot);
+		}
+		pending_.clear();
+		if (emit_depth_ == 0) {
+			settle();
+		}
+	}
+	void reserve(std::size_t n) {
+		slots_.reserve(n);
+	}
+
+	/*
+		\brief	依次直接调用所有可调用的槽并丢弃结果,参数以左值传递给每一个槽
+	*/
+	template<class...Ts>
+	void operator()(Ts&&...args) {
+		{
+			EmitScope scope(*this);
+			//emit期间slots_不会增删元素,因此只在开始时取一次大小
+			std::size_t n = slots_.size();
+			for (std::size_t i = 0; i != n; ++i) {
+				auto& slot = slots_[i];
+				if (slot.is_callable()) {
+					slot.func(args...);
+				}
+			}
+		}
+		if (emit_depth_ == 0) {
+			settle();
+		}
+	}
+	/*
+		\brief	同BasicSignal::emit,最后一个槽得到参数的右值,其余的槽以const&接收;
+				最后一个槽不可调用时所有的槽都以const&接收
+	*/
+	void emit(Ps...args) {
+		{
+			EmitScope scope(*this);
+			std::size_t n = slots_.size();
+			std::size_t last = n - 1;
+			for (std::size_t i = 0; i != n; ++i) {
+				auto& slot = slots_[i];
+				if (!slot.is_callable()) {
+					continue;
+				}
+				if (i == last) {
+					slot.func(std::forward<Ps>(args)...);
+				} else {
+					slot.func(static_cast<SharedArgT<Ps>>(args)...);
+				}
+			}
+		}
+		if (emit_depth_ == 0) {
+			settle();
+		}
+	}
+	/*
+		\brief	以结果组合器调用所有的槽,组合器协议与BasicSignal::collect相同
+	*/
+	template<class ResCombiner,class...Ts>
+	decltype(auto) collect(ResCombiner&& res_collector, Ts&&...args) {
+		EmitScope scope(*this);
+		auto range = makeIndexSlotRange(slots_);
+		using Iter = decltype(range.first);
+		using Cache = CacheRes<R>;
+		auto getter = [&args...](Cache& cache, const Iter& iter)->typename Cache::reference_type
+		{
+			if (!cache) {
+				cache.reset(iter, args...);
+			}
+			return cache.get();
+		};
+		Cache cache{};
+		return forward_m(res_collector)(
+			makeSlotIter<R>(range.first, getter, cache),
+			makeSlotIter<R>(range.second, getter, cache),
+			*this
+		);
+	}
+
+	/*
+		\brief	按连接的顺序访问所有的槽,可以直接遍历其中的函数对象(如成员函数的对象指针).
+		\note	emit期间断开的槽仍在其中(removed为true),直到最外层的emit结束.
+	*/
+	const container& slots()const noexcept {
+		return slots_;
+	}
+	std::size_t size()const noexcept {
+		std::size_t n = pending_.size();
+		for (auto& slot : slots_) {
+			if (!slot.removed) {
+				++n;
+			}
+		}
+		return n;
+	}
+	bool empty()const noexcept {
+		return size() == 0;
+	}
+	std::size_t emission_depth()const noexcept {
+		return emit_depth_;
+	}
+};
+
+/*
+	\brief	以同一个成员函数订阅不同对象的信号,如
+				MemberSignal<void(int), Widget, void(Widget::*)(int)> sig;
+				sig.connect(&widget, &Widget::onValue);
+*/
+template<class Signature,class Obj,class MemPtr>
+using MemberSignal = HomogeneousSignal<Signature, MemFun<Obj*, MemPtr, Signature>>;
+
+}//namespace Talg
+
+#include "undef_macro.h"
@@ -0,0 +1,219 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include "slotlist.h"
+#include "basic_macro_impl.h"
+
+namespace Talg {
+
+namespace IndexedSignalDetail {
+	template<class T>
+	struct TypeTag {
+		static const char id;
+	};
+	template<class T>
+	const char TypeTag<T>::id = 0;
+
+	template<class T>
+	std::size_t typeKey()noexcept {
+		return std::hash<const void*>{}(&TypeTag<T>::id);
+	}
+	inline std::size_t combine(std::size_t seed, std::size_t val)noexcept {
+		return seed ^ (val + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+	}
+	template<class T>
+	std::size_t valueHash(const T& val, std::true_type)noexcept {
+		return std::hash<T>{}(val);
+	}
+	template<class T>
+	std::size_t valueHash(const T&, std::false_type)noexcept {
+		return 0;
+	}
+}
+
+/*
+	\brief	函数对象的散列,必须与槽的相等比较一致:相等的两个函数对象散列值相同.
+			由于EqualableFunction(以及SmallFunction)只在保存的类型与查询的类型完全相同时
+			才可能相等,默认以类型本身作为散列值.
+			可以为自己的函数对象类型特化该模板以提供更好的散列.
+	\note	indexable返回false表示该对象作为查询条件时可能与不同散列值的槽相等
+			(如对象指针为空的MemFun),此时只能线性查找.
+*/
+template<class F>
+struct FunctorHash {
+	static bool indexable(const F&)noexcept {
+		return true;
+	}
+	static std::size_t hash(const F&)noexcept {
+		return IndexedSignalDetail::typeKey<F>();
+	}
+};
+
+/*
+	\brief	函数指针与算术类型还会散列其值,其他类型只能以类型区分.
+*/
+template<class T,class S>
+struct FunctorHash<FunctorImp<T, S>> {
+	using hashable = std::integral_constant<bool,
+		std::is_pointer<T>::value || std::is_arithmetic<T>::value || std::is_enum<T>::value>;
+	static bool indexable(const FunctorImp<T, S>&)noexcept {
+		return true;
+	}
+	static std::size_t hash(const FunctorImp<T, S>& func)noexcept {
+		return IndexedSignalDetail::combine(IndexedSignalDetail::typeKey<FunctorImp<T, S>>(),
+			IndexedSignalDetail::valueHash(func.getFunc(), hashable{}));
+	}
+};
+
+/*
+	\brief	成员函数以对象指针散列,因此同一个对象的所有槽落在同一个桶中.
+*/
+template<class ObjPtr,class MemPtr,class S>
+struct FunctorHash<MemFun<ObjPtr, MemPtr, S>> {
+	using F = MemFun<ObjPtr, MemPtr, S>;
+	static bool indexable(const F& func)noexcept {
+		return func.object() != nullptr;
+	}
+	static std::size_t hash(const F& func)noexcept {
+		return IndexedSignalDetail::combine(IndexedSignalDetail::typeKey<F>(),
+			std::hash<const void*>{}(func.object()));
+	}
+};
+
+/*
+	\brief	带有散列索引的信号,disconnect(func)及disconnect_one(func)平均为O(1).
+			索引以FunctorHash为键,保存各槽的State(从而得到槽的前驱,可以直接删除),
+			State与返回的Connection共享.
+	\note	connect返回的是SharedConnection.
+			通过Connection断开或在emit期间断开的槽在索引中留下失效的项,
+			它们在查找时或索引增长到一定程度时被清除.
+			同一个桶中有多个相等的槽时disconnect_one删除连接得最早的那个,与线性查找的结果一致.
+*/
+template<class Signature,
+		 class SlotTrait = DefaultSlotTraits<EqualableFunction<Signature>>
+>
+class BasicIndexedSignal;
+
+template<class R,class...Ps,class SlotTrait_>
+class BasicIndexedSignal<R(Ps...),SlotTrait_>
+	:public BasicSignal<R(Ps...),SlotTrait_>
+{
+	using Base = BasicSignal<R(Ps...), SlotTrait_>;
+	using Base::slot_list;
+public:
+	using typename Base::State;
+	using typename Base::iterator;
+	using Connection = typename Base::SharedConnection;
+private:
+	struct Entry {
+		std::uint64_t seq;
+		std::shared_ptr<State> state;
+	};
+	using Index = std::unordered_multimap<std::size_t, Entry>;
+	Index index_;
+	std::uint64_t next_seq_ = 0;
+	std::size_t sweep_at_ = 64;
+
+	void eraseSlot(State& state) {
+		iterator prev = state.prev_node_;
+		iterator next = slot_list.erase_after(prev);
+		if (next != slot_list.end() && next->state != nullptr) {
+			next->state->prev_node_ = prev;
+		}
+	}
+	void sweep() {
+		for (auto iter = index_.begin(); iter != index_.end();) {
+			if (iter->second.state->is_disconnected()) {
+				iter = index_.erase(iter);
+			} else {
+				++iter;
+			}
+		}
+		sweep_at_ = index_.size() * 2 > 64 ? index_.size() * 2 : 64;
+	}
+	template<class F>
+	std::size_t disconnectIndexed(const F& func, bool only_one) {
+		auto range = index_.equal_range(FunctorHash<F>::hash(func));
+		auto first_match = index_.end();
+		std::size_t count = 0;
+		for (auto iter = range.first; iter != range.second;) {
+			State& state = *iter->second.state;
+			if (state.is_disconnected()) {
+				iter = index_.erase(iter);
+				continue;
+			}
+			auto slot = std::next(state.prev_node_);
+			if (!slot->busy && *slot == func) {
+				if (!only_one) {
+					eraseSlot(state);
+					iter = index_.erase(iter);
+					++count;
+					continue;
+				}
+				if (first_match == index_.end() || iter->second.seq < first_match->second.seq) {
+					first_match = iter;
+				}
+			}
+			++iter;
+		}
+		if (first_match != index_.end()) {
+			eraseSlot(*first_match->second.state);
+			index_.erase(first_match);
+			++count;
+		}
+		return count;
+	}
+public:
+	BasicIndexedSignal() = default;
+	BasicIndexedSignal(const BasicIndexedSignal&) = delete;
+	BasicIndexedSignal& operator=(const BasicIndexedSignal&) = delete;
+
+	template<class F>
+	Connection connect(F&& func) {
+		using Func = std::decay_t<F>;
+		std::size_t key = FunctorHash<Func>::hash(func);
+		auto con = std::make_shared<State>(slot_list.before_end(), slot_list);
+		slot_list.emplace_back(con.get(), forward_m(func));
+		index_.emplace(key, Entry{ next_seq_++, con });
+		if (index_.size() > sweep_at_) {
+			sweep();
+		}
+		return con;
+	}
+	template<class F>
+	void disconnect(F&& func) {
+		if (FunctorHash<std::decay_t<F>>::indexable(func)) {
+			disconnectIndexed(func, false);
+		} else {
+			Base::disconnect(forward_m(func));
+		}
+	}
+	template<class F>
+	void disconnect_one(F&& func) {
+		if (FunctorHash<std::decay_t<F>>::indexable(func)) {
+			disconnectIndexed(func, true);
+		} else {
+			Base::disconnect_one(forward_m(func));
+		}
+	}
+	void disconnect_all() {
+		Base::disconnect_all();
+		index_.clear();
+	}
+	/*
+		\brief	索引中的项数,包括尚未清除的失效项
+	*/
+	std::size_t index_size()const noexcept {
+		return index_.size();
+	}
+};
+
+template<class...Ts>
+using IndexedSignal = SignalWrapper<BasicIndexedSignal, Ts...>;
+
+}//namespace Talg
+
+#include "undef_macro.h"
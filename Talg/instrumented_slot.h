@@ -0,0 +1,166 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "slotlist.h"
+#include "chrono_io.h"
+#include "basic_macro_impl.h"
+
+namespace Talg {
+
+/*
+	\brief	单个槽的调用统计:调用次数,累计耗时,最大耗时以及按2的幂分桶的耗时直方图.
+	\note	第i个桶统计耗时在[2^i,2^(i+1))纳秒之间的调用,0ns计入第0个桶,
+			超出范围的计入最后一个桶(约2秒以上).
+*/
+struct SlotStats {
+	using duration = std::chrono::nanoseconds;
+	static constexpr std::size_t bucket_count = 32;
+
+	std::uint64_t calls = 0;
+	duration total{ 0 };
+	duration max{ 0 };
+	std::array<std::uint64_t, bucket_count> histogram{};
+
+	static std::size_t bucketOf(duration d)noexcept {
+		auto ns = d.count();
+		std::size_t bucket = 0;
+		while (ns > 1 && bucket + 1 < bucket_count) {
+			ns >>= 1;
+			++bucket;
+		}
+		return bucket;
+	}
+	void record(duration d)noexcept {
+		++calls;
+		total += d;
+		if (d > max) {
+			max = d;
+		}
+		++histogram[bucketOf(d)];
+	}
+	duration mean()const noexcept {
+		return calls == 0 ? duration{ 0 } : total / static_cast<duration::rep>(calls);
+	}
+	void reset()noexcept {
+		*this = SlotStats{};
+	}
+};
+
+/*
+	\brief	以chrono_io的格式输出统计的摘要,如"calls=3 total=120ns mean=40ns max=90ns"
+*/
+template<class Out>
+Out& operator<<(Out& out, const SlotStats& stats) {
+	out << "calls=" << stats.calls
+		<< " total=" << stats.total
+		<< " mean=" << stats.mean()
+		<< " max=" << stats.max;
+	return out;
+}
+
+/*
+	\brief	在Functor之外记录每次调用的耗时,用作DefaultSlotTraits的函数对象.
+	\param	Clock 计时用的时钟,默认为steady_clock
+	\note	相等比较沿用Functor的,因此disconnect(func)与未插桩时一致.
+			槽抛出异常时本次调用同样被记录.
+*/
+template<class Functor,class Clock = std::chrono::steady_clock>
+class InstrumentedFunctor :public Functor {
+	mutable SlotStats stats_;
+
+	struct Timer {
+		SlotStats& stats;
+		typename Clock::time_point start;
+		~Timer() {
+			stats.record(std::chrono::duration_cast<SlotStats::duration>(Clock::now() - start));
+		}
+	};
+public:
+	using Base = Functor;
+	template<class T>
+	using rebind = InstrumentedFunctor<RebindFunctor<Functor, T>, Clock>;
+
+	InstrumentedFunctor() = default;
+	template<class F,
+			 class = std::enable_if_t<!std::is_base_of<InstrumentedFunctor, std::decay_t<F>>::value>>
+	InstrumentedFunctor(F&& func)
+		:Base(forward_m(func))
+	{
+
+	}
+
+	template<class...Ts>
+	decltype(auto) operator()(Ts&&...args)const {
+		Timer timer{ stats_, Clock::now() };
+		return Base::operator()(forward_m(args)...);
+	}
+
+	const SlotStats& stats()const noexcept {
+		return stats_;
+	}
+	void reset_stats()const noexcept {
+		stats_.reset();
+	}
+};
+
+/*
+	\brief	可以直接替换DefaultSlotTraits的插桩版本
+*/
+template<class Functor,
+		 class Clock = std::chrono::steady_clock,
+		 template<class...>class Container = SingleList>
+using InstrumentedSlotTraits = DefaultSlotTraits<InstrumentedFunctor<Functor, Clock>, Container>;
+
+/*
+	\brief	按编译期开关选择是否插桩,关闭时即为DefaultSlotTraits<Functor,Container>本身,
+			信号的类型与代码路径都与未插桩时完全相同.
+*/
+template<class Functor,bool enable,template<class...>class Container = SingleList>
+using SelectInstrumentedSlotTraits = std::conditional_t<enable,
+	InstrumentedSlotTraits<Functor, std::chrono::steady_clock, Container>,
+	DefaultSlotTraits<Functor, Container>>;
+
+template<class Signature>
+using InstrumentedSignal = SimpleSignal<Signature, InstrumentedSlotTraits<EqualableFunction<Signature>>>;
+
+/*
+	\brief	某个槽在快照时的状态
+	\param	index 槽在调用顺序中的位置,callable 当时是否可调用(未被阻塞或断开)
+*/
+struct SlotSnapshot {
+	std::size_t index;
+	bool callable;
+	SlotStats stats;
+};
+
+/*
+	\brief	按调用顺序列出sig中的所有槽及其统计
+	\param	sig 槽的函数对象为InstrumentedFunctor的信号
+*/
+template<class Signal>
+std::vector<SlotSnapshot> snapshotStats(const Signal& sig) {
+	std::vector<SlotSnapshot> res;
+	std::size_t index = 0;
+	for (auto& slot : sig.slots()) {
+		res.push_back(SlotSnapshot{ index++, slot.is_callable(), slot.stats() });
+	}
+	return res;
+}
+
+/*
+	\brief	清空sig中所有槽的统计
+*/
+template<class Signal>
+void resetStats(const Signal& sig)noexcept {
+	for (auto& slot : sig.slots()) {
+		slot.reset_stats();
+	}
+}
+
+}//namespace Talg
+
+#include "undef_macro.h"
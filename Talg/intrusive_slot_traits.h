@@ -0,0 +1,175 @@
+#pragma once
+#include "slotlist.h"
+#include "basic_macro_impl.h"
+
+namespace Talg {
+
+/*
+	\brief	State直接嵌在槽里,槽保存在ChunkList中,因此connect不再为State单独分配内存.
+			连接句柄只是{链表,节点编号,代数},槽被删除后节点的代数改变,旧句柄随之失效.
+	\param	Functor 槽的函数对象类型
+	\note	句柄不拥有任何东西,销毁句柄不会影响连接,但句柄不可以比信号活得更久.
+			槽不可复制,因此使用该特性的信号也不可复制.
+*/
+template<class Functor>
+struct IntrusiveSlotTraits {
+	template<class T>
+	using rebind = IntrusiveSlotTraits<RebindFunctor<Functor, T>>;
+
+	enum SlotState :char {
+		free = 0, discon = 2, blocked = 4, locked = 8
+	};
+	struct SlotType;
+	using container = ChunkList<SlotType>;
+	using iterator = typename container::iterator;
+	using const_iterator = typename container::const_iterator;
+
+	struct State {
+		container* ref = nullptr;
+		iterator prev_node_;
+		SlotState state = free;
+
+		State(iterator link, container& src)noexcept
+			:ref(&src), prev_node_(link)
+		{	}
+		void lock()noexcept {
+			state = locked;
+		}
+		void block()noexcept {
+			if (state != discon) {
+				state = blocked;
+			}
+		}
+		void unblock()noexcept {
+			if (state != discon) {
+				state = free;
+			}
+		}
+		bool is_blocked()const noexcept {
+			return state == blocked || state == locked;
+		}
+		bool is_disconnected()const noexcept {
+			return state == discon;
+		}
+		bool is_connected()const noexcept {
+			return state != discon;
+		}
+		SlotState disconnect() {
+			if (state != free) {
+				return state;
+			}
+			if (std::next(prev_node_)->busy) {
+				return locked;
+			}
+			//erase之后this已经随槽一起析构,所以先取出所需的成员
+			container* list = ref;
+			iterator prev = prev_node_;
+			iterator next = list->erase_after(prev);
+			if (next != list->end()) {
+				next->state->prev_node_ = prev;
+			}
+			return discon;
+		}
+	};
+
+	struct SlotType :Functor {
+		using Base = Functor;
+		State self;
+		State* state;	//总是指向self,保留该成员是为了与BasicSignal及CheckCallIterator的用法一致
+		mutable bool busy = false;	//见DefaultSlotTraits::SlotType::busy
+
+		template<class...Ts>
+		SlotType(iterator prev, container& list, Ts&&...args)
+			:Base(forward_m(args)...), self(prev, list), state(&self)
+		{	}
+		SlotType(const SlotType&) = delete;
+		SlotType& operator=(const SlotType&) = delete;
+		~SlotType() {
+			self.state = discon;
+		}
+		auto lock(State&) {
+			assert(self.state == free);
+			self.lock();
+			auto when_exit = [](State* s) {
+				s->unblock();
+			};
+			return std::unique_ptr<State, decltype(when_exit)>(&self, when_exit);
+		}
+		bool is_callable()const noexcept {
+			return !busy && self.state == free;
+		}
+	};
+
+	/*
+		\brief	连接句柄,可以随意复制,所有操作都先以代数检查槽是否还存在.
+		\note	提供operator->是为了可以像DefaultSlotTraits::Connection那样写con->disconnect().
+	*/
+	class Connection {
+		container* ref_ = nullptr;
+		typename container::Handle handle_;
+
+		State* get()const noexcept {
+			if (ref_ == nullptr) {
+				return nullptr;
+			}
+			SlotType* slot = ref_->get(handle_);
+			return slot == nullptr ? nullptr : &slot->self;
+		}
+	public:
+		Connection()noexcept = default;
+		Connection(container& list, const_iterator pos)noexcept
+			:ref_(&list), handle_(list.handle(pos))
+		{	}
+
+		SlotState disconnect() {
+			if (State* s = get()) {
+				return s->disconnect();
+			}
+			return discon;
+		}
+		void block()noexcept {
+			if (State* s = get()) {
+				s->block();
+			}
+		}
+		void unblock()noexcept {
+			if (State* s = get()) {
+				s->unblock();
+			}
+		}
+		bool is_blocked()const noexcept {
+			State* s = get();
+			return s != nullptr && s->is_blocked();
+		}
+		bool is_disconnected()const noexcept {
+			return get() == nullptr;
+		}
+		bool is_connected()const noexcept {
+			return get() != nullptr;
+		}
+		Connection* operator->()noexcept {
+			return this;
+		}
+		const Connection* operator->()const noexcept {
+			return this;
+		}
+	};
+	using SharedConnection = Connection;
+	using DefaultResCombiner = typename DefaultSlotTraits<Functor>::DefaultResCombiner;
+
+	template<class...Ts>
+	static Connection connectSlot(container& list, Ts&&...func) {
+		iterator prev = list.before_end();
+		return Connection(list, list.emplace_after(prev, prev, list, forward_m(func)...));
+	}
+};
+
+/*
+	\brief	connect时既不为State也不为函数对象(不超过Capacity字节时)分配内存的信号.
+*/
+template<class Signature,std::size_t Capacity = 48>
+using IntrusiveSignal = SimpleSignal<Signature, IntrusiveSlotTraits<SmallFunction<Signature, Capacity>>>;
+
+}//namespace Talg
+
+#include "undef_macro.h"
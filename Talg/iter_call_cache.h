@@ -1,6 +1,10 @@
 #pragma once
 #include <type_traits>
 #include <memory>	//for std::addressof
+#include <functional>	//for std::reference_wrapper
+#include <tuple>
+#include <utility>
+#include <vector>
 #include "core.h"
 #include "basic_macro_impl.h"
 
@@ -79,9 +83,12 @@ public:
 };
 template<class T>
 struct OptionalVal {
-	union {
+	union Storage {
 		T val;
 		bool dummy;
+		//T不是平凡类型时联合体的特殊成员函数会被删除,因此需要显式提供
+		Storage()noexcept :dummy(false) {}
+		~Storage() {}
 	}val;
 	bool is_active=false;
 	OptionalVal()noexcept = default;
@@ -120,6 +127,26 @@ struct OptionalVal {
 
 
 
+/*
+	\brief	同一个参数要依次传递给多个槽时,除最后一个槽之外的传递方式:
+			值类型以const T&传递,使得槽的形参是引用(或不使用该参数)时不发生复制;
+			引用类型保持原样.
+*/
+template<class P>
+struct SharedArg {
+	using type = const P&;
+};
+template<class P>
+struct SharedArg<P&> {
+	using type = P&;
+};
+template<class P>
+struct SharedArg<P&&> {
+	using type = P&&;
+};
+template<class P>
+using SharedArgT = typename SharedArg<P>::type;
+
 template<class R>
 struct CacheRes:public OptionalVal<R> {
 	 //todo: we shall use a std::optional<R> instead of unique_ptr.
@@ -179,6 +206,94 @@ public:
 };
 
 
+/*
+	\brief	供emit_batch使用的缓存,一次reset就以batch中的每组参数依次调用同一个槽,
+			使槽的代码与其捕获的状态在整批调用期间保持在缓存中.
+	\param	R 槽的返回类型,Batch 元素为参数元组(支持std::tuple_size及std::get)的范围
+	\note	get()返回该槽对整批参数的结果,顺序与batch一致;存放结果的vector在各槽之间复用.
+			参数以左值的形式传递给槽.
+*/
+template<class R,class Batch>
+class BatchCache {
+public:
+	using stored_type		= std::conditional_t<std::is_lvalue_reference<R>::value,
+								std::reference_wrapper<std::remove_reference_t<R>>,
+								std::decay_t<R>>;
+	using reference_type	= const std::vector<stored_type>&;
+	using value_type		= const std::vector<stored_type>;
+	using pointer			= const std::vector<stored_type>*;
+private:
+	const Batch* batch_;
+	std::vector<stored_type> results_;
+	bool is_called = false;
+
+	template<class Slot,class Args,std::size_t...Is>
+	static decltype(auto) invoke(Slot& slot, Args& args, std::index_sequence<Is...>) {
+		return slot(std::get<Is>(args)...);
+	}
+public:
+	explicit BatchCache(const Batch& batch)
+		:batch_(std::addressof(batch)) {}
+
+	template<class Iter>
+	void reset(const Iter& iter) {
+		results_.clear();
+		for (auto& args : *batch_) {
+			using Args = std::remove_reference_t<decltype(args)>;
+			results_.push_back(invoke(*iter, args,
+				std::make_index_sequence<std::tuple_size<std::remove_cv_t<Args>>::value>{}));
+		}
+		is_called = true;
+	}
+	void reset()noexcept {
+		is_called = false;
+	}
+	explicit operator bool()const noexcept {
+		return is_called;
+	}
+	reference_type get()const noexcept {
+		return results_;
+	}
+};
+
+template<class Batch>
+class BatchCache<void,Batch> {
+public:
+	using reference_type	= const BatchCache&;
+	using value_type		= const BatchCache;
+	using pointer			= const BatchCache*;
+private:
+	const Batch* batch_;
+	bool is_called = false;
+
+	template<class Slot,class Args,std::size_t...Is>
+	static void invoke(Slot& slot, Args& args, std::index_sequence<Is...>) {
+		slot(std::get<Is>(args)...);
+	}
+public:
+	explicit BatchCache(const Batch& batch)
+		:batch_(std::addressof(batch)) {}
+
+	template<class Iter>
+	void reset(const Iter& iter) {
+		for (auto& args : *batch_) {
+			using Args = std::remove_reference_t<decltype(args)>;
+			invoke(*iter, args,
+				std::make_index_sequence<std::tuple_size<std::remove_cv_t<Args>>::value>{});
+		}
+		is_called = true;
+	}
+	void reset()noexcept {
+		is_called = false;
+	}
+	explicit operator bool()const noexcept {
+		return is_called;
+	}
+	reference_type get()const noexcept {
+		return *this;
+	}
+};
+
 }//namespace Talg
 
 
@@ -0,0 +1,119 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include "slotlist.h"
+#include "basic_macro_impl.h"
+
+namespace Talg {
+
+/*
+	\brief	空的时候只占一个指针的信号,第一次connect时才分配内部的BasicSignal.
+			适合于每个对象都带有许多信号但大多数信号没有槽的情形.
+	\param	同BasicSignal
+	\note	emit一个从未connect过的信号只需一次判断.
+			内部信号一旦分配就一直保留到信号析构,使得已有的Connection始终有效.
+			collect在没有槽时以一个(线程局部的)空信号调用组合器,因此组合器看到的总是空的范围.
+*/
+template<class Signature,
+		 class SlotTrait = DefaultSlotTraits<EqualableFunction<Signature>>
+>
+class BasicLazySignal;
+
+template<class R,class...Ps,class SlotTrait>
+class BasicLazySignal<R(Ps...),SlotTrait> {
+public:
+	using Signal = BasicSignal<R(Ps...), SlotTrait>;
+	using Connection = typename Signal::Connection;
+	using SharedConnection = typename Signal::SharedConnection;
+	using DefaultResCombiner = typename Signal::DefaultResCombiner;
+private:
+	std::unique_ptr<Signal> impl_;
+
+	Signal& get() {
+		if (impl_ == nullptr) {
+			impl_ = std::make_unique<Signal>();
+		}
+		return *impl_;
+	}
+	static Signal& emptySignal() {
+		static thread_local Signal sig;
+		return sig;
+	}
+public:
+	BasicLazySignal() = default;
+	BasicLazySignal(BasicLazySignal&&) noexcept = default;
+	BasicLazySignal& operator=(BasicLazySignal&&) noexcept = default;
+
+	template<class...Ts>
+	Connection connect(Ts&&...func) {
+		return get().connect(forward_m(func)...);
+	}
+	template<class F>
+	void disconnect(F&& func) {
+		if (impl_ != nullptr) {
+			impl_->disconnect(forward_m(func));
+		}
+	}
+	template<class F>
+	void disconnect_one(F&& func) {
+		if (impl_ != nullptr) {
+			impl_->disconnect_one(forward_m(func));
+		}
+	}
+	void disconnect_all() {
+		if (impl_ != nullptr) {
+			impl_->disconnect_all();
+		}
+	}
+	bool empty()const noexcept {
+		return impl_ == nullptr || impl_->empty();
+	}
+	/*
+		\brief	是否已经分配了内部信号
+	*/
+	bool allocated()const noexcept {
+		return impl_ != nullptr;
+	}
+
+	template<class...Ts>
+	void operator()(Ts&&...args) {
+		if (impl_ != nullptr) {
+			(*impl_)(forward_m(args)...);
+		}
+	}
+	void emit(Ps...args) {
+		if (impl_ != nullptr) {
+			impl_->emit(std::forward<Ps>(args)...);
+		}
+	}
+	template<class...Ts>
+	void emit_guarded(Ts&&...args) {
+		if (impl_ != nullptr) {
+			impl_->emit_guarded(forward_m(args)...);
+		}
+	}
+	template<class ResCombiner,class...Ts>
+	decltype(auto) collect(ResCombiner&& res_collector, Ts&&...args) {
+		auto& sig = impl_ != nullptr ? *impl_ : emptySignal();
+		return sig.collect(forward_m(res_collector), forward_m(args)...);
+	}
+	template<class ResCombiner,class...Ts>
+	decltype(auto) collect_guarded(ResCombiner&& res_collector, Ts&&...args) {
+		auto& sig = impl_ != nullptr ? *impl_ : emptySignal();
+		return sig.collect_guarded(forward_m(res_collector), forward_m(args)...);
+	}
+	std::size_t emission_depth()const noexcept {
+		return impl_ == nullptr ? 0 : impl_->emission_depth();
+	}
+	std::size_t purge_expired() {
+		return impl_ == nullptr ? 0 : impl_->purge_expired();
+	}
+};
+
+template<class...Ts>
+using LazySignal = SignalWrapper<BasicLazySignal, Ts...>;
+
+}//namespace Talg
+
+#include "undef_macro.h"
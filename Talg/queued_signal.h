@@ -0,0 +1,243 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include "concurrent_signal.h"
+#include "bounded_queue.h"
+#include "basic_macro_impl.h"
+
+namespace Talg {
+
+/*
+	\brief	队列满时emit的行为
+	\note	block: 等待直到有空位;
+			drop_oldest: 丢弃队首最旧的事件以腾出空位;
+			drop_newest: 丢弃这次emit的事件.
+*/
+enum class OverflowPolicy :char {
+	block, drop_oldest, drop_newest
+};
+
+/*
+	\brief	异步的信号,emit只把参数复制(或移动)进有界队列就返回,
+			由分发线程从队列中批量取出事件并调用内部信号的槽.
+	\param	Signature 必须形如void(Ps...),Inner 内部信号的类型,
+			默认为BasicConcurrentSignal<Signature>,因此可以在任何线程中connect/disconnect,
+			多个分发线程也可以同时调用槽.
+	\note	参数以std::decay_t<Ps>的形式保存,槽收到的是对这份副本的左值引用.
+			只有一个分发线程时事件按入队的顺序被处理.
+			分发线程数为0时由使用者调用poll来处理事件,此时不应使用block策略,
+			除非另有线程在调用poll.
+			若Inner为BasicSignal<Signature>,则只能有一个分发线程,并且必须在emit之前完成connect.
+*/
+template<class Signature,class Inner = BasicConcurrentSignal<Signature>>
+class BasicQueuedSignal;
+
+template<class...Ps,class Inner>
+class BasicQueuedSignal<void(Ps...),Inner> {
+	using Signal = Inner;
+	using Event = std::tuple<std::decay_t<Ps>...>;
+public:
+	using Connection = typename Signal::Connection;
+	using SharedConnection = typename Signal::SharedConnection;
+private:
+	Signal signal_;
+	BoundedQueue<Event> queue_;
+	const OverflowPolicy policy_;
+	const std::size_t batch_size_;
+	std::mutex mtx_;
+	std::condition_variable not_empty_;
+	std::condition_variable not_full_;
+	std::condition_variable idle_;
+	std::atomic<std::size_t> sleepers_{0};		//等待事件的分发线程数
+	std::atomic<std::size_t> blocked_{0};		//等待空位的生产者数
+	std::atomic<std::size_t> pending_{0};		//已经emit但还没有处理完的事件数
+	std::atomic<std::size_t> dropped_{0};
+	bool stop_ = false;							//受mtx_保护
+	std::vector<std::thread> dispatchers_;
+
+	template<std::size_t...Is>
+	void invoke(Event& ev, std::index_sequence<Is...>) {
+		signal_(std::get<Is>(ev)...);
+	}
+	void finish(std::size_t n) {
+		if (pending_.fetch_sub(n, std::memory_order_acq_rel) == n) {
+			std::lock_guard<std::mutex> lock(mtx_);
+			idle_.notify_all();
+		}
+	}
+	void wakeDispatcher() {
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (sleepers_.load(std::memory_order_relaxed) != 0) {
+			std::lock_guard<std::mutex> lock(mtx_);
+			not_empty_.notify_one();
+		}
+	}
+	void wakeProducers() {
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (blocked_.load(std::memory_order_relaxed) != 0) {
+			std::lock_guard<std::mutex> lock(mtx_);
+			not_full_.notify_all();
+		}
+	}
+	bool push(Event& ev) {
+		pending_.fetch_add(1, std::memory_order_relaxed);
+		switch (policy_) {
+		case OverflowPolicy::block:
+			while (!queue_.try_push(ev)) {
+				std::unique_lock<std::mutex> lock(mtx_);
+				blocked_.fetch_add(1, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				not_full_.wait(lock, [this] { return queue_.size_approx() < queue_.capacity(); });
+				blocked_.fetch_sub(1, std::memory_order_relaxed);
+			}
+			break;
+		case OverflowPolicy::drop_oldest:
+			while (!queue_.try_push(ev)) {
+				if (queue_.try_pop([](Event&&) {})) {
+					dropped_.fetch_add(1, std::memory_order_relaxed);
+					finish(1);
+				}
+			}
+			break;
+		case OverflowPolicy::drop_newest:
+			if (!queue_.try_push(ev)) {
+				dropped_.fetch_add(1, std::memory_order_relaxed);
+				finish(1);
+				return false;
+			}
+			break;
+		}
+		wakeDispatcher();
+		return true;
+	}
+	std::size_t drain(std::size_t max_count) {
+		std::size_t count = 0;
+		while (count != max_count && queue_.try_pop([this](Event&& ev) {
+			invoke(ev, std::index_sequence_for<Ps...>{});
+		})) {
+			++count;
+		}
+		if (count != 0) {
+			wakeProducers();
+			finish(count);
+		}
+		return count;
+	}
+	void run() {
+		for (;;) {
+			if (drain(batch_size_) != 0) {
+				continue;
+			}
+			std::unique_lock<std::mutex> lock(mtx_);
+			sleepers_.fetch_add(1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			not_empty_.wait(lock, [this] { return stop_ || !queue_.empty_approx(); });
+			sleepers_.fetch_sub(1, std::memory_order_relaxed);
+			if (stop_ && queue_.empty_approx()) {
+				return;
+			}
+		}
+	}
+public:
+	/*
+		\param	capacity 队列容量(向上取整为2的幂),policy 队列满时的策略,
+				dispatcher_count 分发线程数,batch_size 分发线程每次醒来之后连续处理的最多事件数
+	*/
+	explicit BasicQueuedSignal(std::size_t capacity = 1024,
+		OverflowPolicy policy = OverflowPolicy::block,
+		std::size_t dispatcher_count = 1,
+		std::size_t batch_size = 64)
+		:queue_(capacity), policy_(policy), batch_size_(batch_size == 0 ? 1 : batch_size)
+	{
+		dispatchers_.reserve(dispatcher_count);
+		for (std::size_t i = 0; i != dispatcher_count; ++i) {
+			dispatchers_.emplace_back([this] { run(); });
+		}
+	}
+	BasicQueuedSignal(const BasicQueuedSignal&) = delete;
+	BasicQueuedSignal& operator=(const BasicQueuedSignal&) = delete;
+	/*
+		\note	分发线程会先处理完队列中剩余的事件再退出.
+	*/
+	~BasicQueuedSignal() {
+		{
+			std::lock_guard<std::mutex> lock(mtx_);
+			stop_ = true;
+		}
+		not_empty_.notify_all();
+		for (auto& th : dispatchers_) {
+			th.join();
+		}
+	}
+
+	template<class...Ts>
+	decltype(auto) connect(Ts&&...func) {
+		return signal_.connect(forward_m(func)...);
+	}
+	template<class F>
+	void disconnect(F&& func) {
+		signal_.disconnect(forward_m(func));
+	}
+	template<class F>
+	void disconnect_one(F&& func) {
+		signal_.disconnect_one(forward_m(func));
+	}
+	void disconnect_all() {
+		signal_.disconnect_all();
+	}
+	bool empty()const {
+		return signal_.empty();
+	}
+
+	/*
+		\brief	把参数放进队列后立即返回
+		\return	事件是否已经入队,只有drop_newest策略下才会返回false
+	*/
+	template<class...Ts>
+	bool operator()(Ts&&...args) {
+		Event ev(forward_m(args)...);
+		return push(ev);
+	}
+	bool emit(Ps...args) {
+		Event ev(forward_m(args)...);
+		return push(ev);
+	}
+
+	/*
+		\brief	在当前线程中处理队列中的事件
+		\param	max_count 最多处理的事件数
+		\return	实际处理的事件数
+	*/
+	std::size_t poll(std::size_t max_count = static_cast<std::size_t>(-1)) {
+		return drain(max_count);
+	}
+	/*
+		\brief	等待直到所有已经emit的事件都被处理或丢弃
+	*/
+	void wait_idle() {
+		std::unique_lock<std::mutex> lock(mtx_);
+		idle_.wait(lock, [this] { return pending_.load(std::memory_order_acquire) == 0; });
+	}
+	std::size_t dropped()const noexcept {
+		return dropped_.load(std::memory_order_relaxed);
+	}
+	std::size_t pending()const noexcept {
+		return pending_.load(std::memory_order_relaxed);
+	}
+	std::size_t capacity()const noexcept {
+		return queue_.capacity();
+	}
+};
+
+template<class...Ts>
+using QueuedSignal = SignalWrapper<BasicQueuedSignal, Ts...>;
+
+}//namespace Talg
+
+#include "undef_macro.h"
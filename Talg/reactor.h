@@ -0,0 +1,482 @@
+#pragma once
+#ifdef __linux__
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include "slotlist.h"
+#include "small_function.h"
+#include "timing_wheel.h"
+#include "basic_macro_impl.h"
+
+namespace Talg {
+
+[[noreturn]] inline void throwErrno(const char* what) {
+	throw std::system_error(errno, std::system_category(), what);
+}
+
+/*
+	\brief	独占一个文件描述符,析构时close
+*/
+class UniqueFd {
+	int fd_ = -1;
+public:
+	UniqueFd()noexcept = default;
+	explicit UniqueFd(int fd)noexcept
+		:fd_(fd)
+	{
+
+	}
+	UniqueFd(UniqueFd&& rhs)noexcept
+		:fd_(rhs.release())
+	{
+
+	}
+	UniqueFd& operator=(UniqueFd&& rhs)noexcept {
+		reset(rhs.release());
+		return *this;
+	}
+	~UniqueFd() {
+		reset();
+	}
+	int get()const noexcept {
+		return fd_;
+	}
+	int release()noexcept {
+		int fd = fd_;
+		fd_ = -1;
+		return fd;
+	}
+	void reset(int fd = -1)noexcept {
+		if (fd_ >= 0) {
+			::close(fd_);
+		}
+		fd_ = fd;
+	}
+	explicit operator bool()const noexcept {
+		return fd_ >= 0;
+	}
+};
+
+/*
+	\brief	非阻塞的eventfd,可以在任何线程中notify
+*/
+class EventFd :public UniqueFd {
+public:
+	explicit EventFd(unsigned int initial = 0)
+		:UniqueFd(::eventfd(initial, EFD_NONBLOCK | EFD_CLOEXEC))
+	{
+		if (!*this) {
+			throwErrno("eventfd");
+		}
+	}
+	void notify(std::uint64_t n = 1)noexcept {
+		//计数器溢出时write以EAGAIN失败,此时本来就处于可读的状态
+		auto res = ::write(get(), &n, sizeof(n));
+		(void)res;
+	}
+	/*
+		\return	读出并清零的计数,没有notify过时为0
+	*/
+	std::uint64_t drain()noexcept {
+		std::uint64_t n = 0;
+		return ::read(get(), &n, sizeof(n)) == sizeof(n) ? n : 0;
+	}
+};
+
+/*
+	\brief	非阻塞的timerfd,到期时可读
+*/
+class TimerFd :public UniqueFd {
+	static timespec toTimespec(std::chrono::nanoseconds d)noexcept {
+		timespec ts;
+		ts.tv_sec = static_cast<time_t>(d.count() / 1000000000);
+		ts.tv_nsec = static_cast<long>(d.count() % 1000000000);
+		return ts;
+	}
+public:
+	explicit TimerFd(int clock_id = CLOCK_MONOTONIC)
+		:UniqueFd(::timerfd_create(clock_id, TFD_NONBLOCK | TFD_CLOEXEC))
+	{
+		if (!*this) {
+			throwErrno("timerfd_create");
+		}
+	}
+	/*
+		\param	initial 第一次到期的相对时间(为0时等于disarm),interval 之后的周期,为0时只触发一次
+	*/
+	template<class Rep1,class Period1,class Rep2 = int,class Period2 = std::ratio<1>>
+	void arm(std::chrono::duration<Rep1, Period1> initial,
+			 std::chrono::duration<Rep2, Period2> interval = std::chrono::duration<Rep2, Period2>::zero()) {
+		itimerspec spec;
+		spec.it_value = toTimespec(std::chrono::duration_cast<std::chrono::nanoseconds>(initial));
+		spec.it_interval = toTimespec(std::chrono::duration_cast<std::chrono::nanoseconds>(interval));
+		if (::timerfd_settime(get(), 0, &spec, nullptr) != 0) {
+			throwErrno("timerfd_settime");
+		}
+	}
+	void disarm() {
+		arm(std::chrono::nanoseconds::zero());
+	}
+	/*
+		\return	上次读取之后到期的次数
+	*/
+	std::uint64_t expirations()noexcept {
+		std::uint64_t n = 0;
+		return ::read(get(), &n, sizeof(n)) == sizeof(n) ? n : 0;
+	}
+};
+
+/*
+	\brief	非阻塞的管道
+	\return	first为读端,second为写端
+*/
+inline std::pair<UniqueFd, UniqueFd> makePipe() {
+	int fds[2];
+	if (::pipe2(fds, O_NONBLOCK | O_CLOEXEC) != 0) {
+		throwErrno("pipe2");
+	}
+	return std::make_pair(UniqueFd(fds[0]), UniqueFd(fds[1]));
+}
+
+class Reactor;
+
+/*
+	\brief	Reactor中的一个文件描述符的注册,fd就绪时发出ready(fd, events)
+	\note	由Reactor持有,unwatch之后(在当前的分发结束时)销毁
+*/
+class IoWatch {
+	friend class Reactor;
+	int fd_;
+	std::uint32_t events_;
+	std::uint32_t gen_;
+public:
+	using Signal = SimpleSignal<void(int, std::uint32_t)>;
+	Signal ready;
+
+	IoWatch(int fd, std::uint32_t events, std::uint32_t gen)noexcept
+		:fd_(fd), events_(events), gen_(gen)
+	{
+
+	}
+	int fd()const noexcept {
+		return fd_;
+	}
+	std::uint32_t events()const noexcept {
+		return events_;
+	}
+};
+
+/*
+	\brief	基于epoll的事件循环.每个注册的文件描述符有一个信号IoWatch::ready,
+			就绪时以(fd, epoll的事件)调用其中的槽;同时驱动一个TimingWheel,
+			以及一个可以从任何线程post的任务队列.
+	\note	epoll_wait的结果批量地放在预先分配的数组中,分发时不分配内存:
+			epoll_event中保存的是注册的下标与代数,因此槽中unwatch(包括其他fd)之后,
+			同一批中该fd剩下的事件会被忽略.
+			文件描述符不归Reactor所有,close之前应当先unwatch.
+			除了post,wake与stop之外的成员只能在运行事件循环的线程中调用.
+*/
+class Reactor {
+public:
+	using Task = SmallFunction<void(), 48>;
+private:
+	static constexpr std::uint32_t nil = ~std::uint32_t(0);
+	static constexpr std::uint64_t wake_key = ~std::uint64_t(0);
+
+	UniqueFd epoll_;
+	EventFd wake_;
+	std::vector<epoll_event> events_;
+	std::vector<std::unique_ptr<IoWatch>> watches_;
+	std::vector<std::uint32_t> free_;
+	std::uint32_t next_gen_ = 0;
+	std::vector<std::uint32_t> by_fd_;			//fd到watches_的下标
+	std::vector<std::unique_ptr<IoWatch>> retired_;	//分发期间unwatch的注册
+	std::size_t dispatch_depth_ = 0;
+	TimingWheel timers_;
+
+	std::mutex mtx_;
+	std::vector<Task> posted_;
+	std::vector<Task> running_;					//与posted_交换以复用内存
+	std::atomic<bool> wake_pending_{ false };
+	std::atomic<bool> stopped_{ false };
+
+	static std::uint64_t keyOf(std::uint32_t index, std::uint32_t gen)noexcept {
+		return (static_cast<std::uint64_t>(gen) << 32) | index;
+	}
+	void control(int op, int fd, std::uint32_t events, std::uint64_t key) {
+		epoll_event ev{};
+		ev.events = events;
+		ev.data.u64 = key;
+		if (::epoll_ctl(epoll_.get(), op, fd, &ev) != 0) {
+			throwErrno("epoll_ctl");
+		}
+	}
+	IoWatch* find(int fd)const noexcept {
+		if (fd < 0 || static_cast<std::size_t>(fd) >= by_fd_.size() || by_fd_[fd] == nil) {
+			return nullptr;
+		}
+		return watches_[by_fd_[fd]].get();
+	}
+
+	struct DispatchScope {
+		Reactor& self;
+		explicit DispatchScope(Reactor& r)noexcept
+			:self(r)
+		{
+			++self.dispatch_depth_;
+		}
+		~DispatchScope() {
+			if (--self.dispatch_depth_ == 0) {
+				self.retired_.clear();
+			}
+		}
+	};
+
+	void dispatch(const epoll_event& ev) {
+		if (ev.data.u64 == wake_key) {
+			wake_.drain();
+			return;
+		}
+		auto index = static_cast<std::uint32_t>(ev.data.u64);
+		auto gen = static_cast<std::uint32_t>(ev.data.u64 >> 32);
+		if (index >= watches_.size()) {
+			return;
+		}
+		auto watch = watches_[index].get();
+		if (watch == nullptr || watch->gen_ != gen) {
+			return;		//已经unwatch
+		}
+		watch->ready(watch->fd_, static_cast<std::uint32_t>(ev.events));
+	}
+	std::size_t runPosted() {
+		wake_pending_.store(false, std::memory_order_release);
+		{
+			std::lock_guard<std::mutex> lock(mtx_);
+			if (posted_.empty()) {
+				return 0;
+			}
+			running_.swap(posted_);
+		}
+		std::size_t n = running_.size();
+		//任务抛出异常时丢弃这一批中剩下的任务,但保证running_被清空
+		struct Clear {
+			std::vector<Task>& tasks;
+			~Clear() {
+				tasks.clear();
+			}
+		} clear{ running_ };
+		for (auto& task : running_) {
+			task();
+		}
+		return n;
+	}
+	int timeoutFor(int timeout_ms)const noexcept {
+		auto wake = timers_.next_wakeup();
+		if (wake == TimingWheel::time_point::max()) {
+			return timeout_ms;
+		}
+		auto now = TimingWheel::clock::now();
+		long long ms = wake <= now ? 0 :
+			std::chrono::duration_cast<std::chrono::milliseconds>(wake - now + std::chrono::milliseconds(1)
+				- TimingWheel::clock::duration(1)).count();
+		if (timeout_ms >= 0 && timeout_ms < ms) {
+			return timeout_ms;
+		}
+		return ms > 0x7fffffff ? 0x7fffffff : static_cast<int>(ms);
+	}
+public:
+	/*
+		\param	batch 每次epoll_wait最多取出的事件数,timer_tick 时间轮的精度
+	*/
+	explicit Reactor(std::size_t batch = 64, std::chrono::milliseconds timer_tick = std::chrono::milliseconds(1))
+		:epoll_(::epoll_create1(EPOLL_CLOEXEC)),
+		events_(batch == 0 ? 1 : batch),
+		timers_(timer_tick)
+	{
+		if (!epoll_) {
+			throwErrno("epoll_create1");
+		}
+		control(EPOLL_CTL_ADD, wake_.get(), EPOLLIN, wake_key);
+	}
+	Reactor(const Reactor&) = delete;
+	Reactor& operator=(const Reactor&) = delete;
+
+	/*
+		\brief	注册fd,返回的IoWatch在unwatch之前一直有效
+		\param	events epoll的事件,如EPOLLIN|EPOLLET
+		\note	同一个fd不能重复注册
+	*/
+	IoWatch& watch(int fd, std::uint32_t events) {
+		if (fd < 0) {
+			throw std::system_error(std::make_error_code(std::errc::bad_file_descriptor), "Reactor::watch");
+		}
+		if (find(fd) != nullptr) {
+			throw std::system_error(std::make_error_code(std::errc::file_exists), "Reactor::watch");
+		}
+		bool reuse = !free_.empty();
+		auto index = reuse ? free_.back() : static_cast<std::uint32_t>(watches_.size());
+		auto watch = std::make_unique<IoWatch>(fd, events, ++next_gen_);
+		//先分配好所有的内存再向epoll注册,注册之后不再有可能失败的操作
+		if (static_cast<std::size_t>(fd) >= by_fd_.size()) {
+			by_fd_.resize(static_cast<std::size_t>(fd) + 1, std::uint32_t(nil));
+		}
+		if (!reuse) {
+			watches_.emplace_back();
+		}
+		try {
+			control(EPOLL_CTL_ADD, fd, events, keyOf(index, watch->gen_));
+		} catch (...) {
+			if (!reuse) {
+				watches_.pop_back();
+			}
+			throw;
+		}
+		if (reuse) {
+			free_.pop_back();
+		}
+		by_fd_[fd] = index;
+		watches_[index] = std::move(watch);
+		return *watches_[index];
+	}
+	/*
+		\brief	注册fd并连接func
+	*/
+	template<class F>
+	IoWatch& watch(int fd, std::uint32_t events, F&& func) {
+		auto& w = watch(fd, events);
+		w.ready.connect(forward_m(func));
+		return w;
+	}
+	/*
+		\brief	修改关注的事件
+	*/
+	void modify(int fd, std::uint32_t events) {
+		auto watch = find(fd);
+		if (watch == nullptr) {
+			throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory), "Reactor::modify");
+		}
+		control(EPOLL_CTL_MOD, fd, events, keyOf(by_fd_[fd], watch->gen_));
+		watch->events_ = events;
+	}
+	/*
+		\return	fd是否注册过
+		\note	可以在槽中调用,包括正在发出信号的fd自己
+	*/
+	bool unwatch(int fd) {
+		auto watch = find(fd);
+		if (watch == nullptr) {
+			return false;
+		}
+		//fd可能已经被close,此时内核已经移除了它
+		epoll_event ev{};
+		::epoll_ctl(epoll_.get(), EPOLL_CTL_DEL, fd, &ev);
+		auto index = by_fd_[fd];
+		by_fd_[fd] = nil;
+		if (dispatch_depth_ != 0) {
+			retired_.push_back(std::move(watches_[index]));
+		} else {
+			watches_[index].reset();
+		}
+		free_.push_back(index);
+		return true;
+	}
+	bool watching(int fd)const noexcept {
+		return find(fd) != nullptr;
+	}
+	std::size_t size()const noexcept {
+		return watches_.size() - free_.size();
+	}
+
+	/*
+		\brief	随Reactor运行的时间轮,回调在事件循环的线程中调用
+	*/
+	TimingWheel& timers()noexcept {
+		return timers_;
+	}
+
+	/*
+		\brief	在事件循环的线程中调用task,可以在任何线程中调用
+	*/
+	template<class F>
+	void post(F&& task) {
+		{
+			std::lock_guard<std::mutex> lock(mtx_);
+			posted_.emplace_back(forward_m(task));
+		}
+		wake();
+	}
+	/*
+		\brief	唤醒阻塞在epoll_wait中的事件循环,多次wake在被处理之前只写一次eventfd
+	*/
+	void wake()noexcept {
+		if (!wake_pending_.exchange(true, std::memory_order_acq_rel)) {
+			wake_.notify();
+		}
+	}
+	/*
+		\brief	使run在当前这一轮之后返回,可以在任何线程中调用
+	*/
+	void stop()noexcept {
+		stopped_.store(true, std::memory_order_release);
+		wake();
+	}
+	bool stopped()const noexcept {
+		return stopped_.load(std::memory_order_acquire);
+	}
+
+	/*
+		\brief	等待至多timeout_ms毫秒(-1为无限,但不会超过下一个定时器),
+				依次分发就绪的fd,到期的定时器以及post的任务
+		\return	分发的fd事件,定时器以及任务的个数
+	*/
+	std::size_t run_once(int timeout_ms = -1) {
+		if (wake_pending_.load(std::memory_order_acquire)) {
+			timeout_ms = 0;
+		}
+		int n = ::epoll_wait(epoll_.get(), events_.data(), static_cast<int>(events_.size()), timeoutFor(timeout_ms));
+		if (n < 0) {
+			if (errno != EINTR) {
+				throwErrno("epoll_wait");
+			}
+			n = 0;
+		}
+		std::size_t count = 0;
+		{
+			DispatchScope scope(*this);
+			for (int i = 0; i != n; ++i) {
+				if (events_[i].data.u64 != wake_key) {
+					++count;
+				}
+				dispatch(events_[i]);
+			}
+			count += timers_.poll();
+		}
+		return count + runPosted();
+	}
+	/*
+		\brief	运行事件循环直到stop,返回之后可以再次run
+	*/
+	void run() {
+		while (!stopped()) {
+			run_once();
+		}
+		stopped_.store(false, std::memory_order_release);
+	}
+};
+
+}//namespace Talg
+
+#include "undef_macro.h"
+#endif //__linux__
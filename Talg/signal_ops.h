@@ -0,0 +1,393 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "seqop.h"
+#include "timing_wheel.h"
+#include "basic_macro_impl.h"
+
+/*
+	在信号之间插入filter,map,take_while,buffer,debounce,sample等操作,如
+		pipe(clicks, filter(isLeft) | map(toPoint) | debounce(wheel, 50ms), points);
+	操作以|组合成OpChain,连接时与目标一起融合成一个函数对象:
+	每个阶段直接(可内联地)调用下一个阶段,因此整条链只有源信号的一次间接调用,
+	而不是每一步都经过一个信号.
+*/
+namespace Talg {
+
+template<class T>
+struct IsSignalOpImp :std::false_type {};
+/*
+	\brief	T是否为操作(或者OpChain),只有操作之间才能以|组合
+*/
+template<class T>
+using IsSignalOp = IsSignalOpImp<std::decay_t<T>>;
+
+namespace SignalOpsImp {
+	//以左值传递保存的参数
+	template<class Next,class Tuple,std::size_t...Is>
+	void callWith(Next& next, Tuple& args, std::index_sequence<Is...>) {
+		next(std::get<Is>(args)...);
+	}
+
+	/*
+		\brief	时间相关的操作的共享状态.定时器只持有它的weak_ptr,
+				因此连接断开后的定时器什么也不做,状态析构时也会取消定时器.
+	*/
+	template<class Wheel,class Next,class...Ts>
+	struct TimedState :std::enable_shared_from_this<TimedState<Wheel, Next, Ts...>> {
+		Wheel* wheel;
+		typename Wheel::duration delay;
+		Next next;
+		std::tuple<Ts...> latest;
+		TimerId timer;
+		bool has_value = false;
+
+		TimedState(Wheel& w, typename Wheel::duration d, Next&& n)
+			:wheel(&w), delay(d), next(std::move(n))
+		{
+
+		}
+		~TimedState() {
+			wheel->cancel(timer);
+		}
+		template<class...Us>
+		void store(Us&&...args) {
+			latest = std::tuple<Ts...>(forward_m(args)...);
+			has_value = true;
+		}
+		void schedule() {
+			std::weak_ptr<TimedState> weak = this->shared_from_this();
+			timer = wheel->schedule_after(delay, [weak] {
+				//触发时锁住状态,使得下游在回调中断开连接也是安全的
+				if (auto self = weak.lock()) {
+					self->fire();
+				}
+			});
+		}
+		void fire() {
+			if (has_value) {
+				has_value = false;
+				SignalOpsImp::callWith(next, latest, std::index_sequence_for<Ts...>{});
+			}
+		}
+	};
+}
+
+/*
+	\brief	把事件转发给signal,用作链的终点
+*/
+template<class Signal>
+struct SignalSink {
+	Signal* sig;
+	template<class...Us>
+	void operator()(Us&&...args)const {
+		(*sig)(forward_m(args)...);
+	}
+};
+
+template<class Pred,class Next>
+struct FilterStage {
+	Pred pred;
+	Next next;
+	template<class...Us>
+	void operator()(Us&&...args) {
+		if (pred(args...)) {
+			next(forward_m(args)...);
+		}
+	}
+};
+template<class F,class Next>
+struct MapStage {
+	F func;
+	Next next;
+	template<class...Us>
+	void operator()(Us&&...args) {
+		next(func(forward_m(args)...));
+	}
+};
+template<class Pred,class Next>
+struct TakeWhileStage {
+	Pred pred;
+	Next next;
+	bool open = true;
+	template<class...Us>
+	void operator()(Us&&...args) {
+		if (open && (open = static_cast<bool>(pred(args...)))) {
+			next(forward_m(args)...);
+		}
+	}
+};
+template<class Elem,class Next>
+struct BufferStage {
+	std::size_t count;
+	Next next;
+	std::vector<Elem> buf;
+	template<class...Us>
+	void operator()(Us&&...args) {
+		if (buf.empty()) {
+			buf.reserve(count);
+		}
+		buf.emplace_back(forward_m(args)...);
+		if (buf.size() >= count) {
+			//以左值传递,清空后保留容量,稳定之后不再分配内存
+			next(static_cast<const std::vector<Elem>&>(buf));
+			buf.clear();
+		}
+	}
+};
+template<class Wheel,class Next,class...Ts>
+struct DebounceStage {
+	std::shared_ptr<SignalOpsImp::TimedState<Wheel, Next, Ts...>> state;
+	template<class...Us>
+	void operator()(Us&&...args) {
+		state->store(forward_m(args)...);
+		state->wheel->cancel(state->timer);
+		state->schedule();
+	}
+};
+template<class Wheel,class Next,class...Ts>
+struct SampleStage {
+	std::shared_ptr<SignalOpsImp::TimedState<Wheel, Next, Ts...>> state;
+	template<class...Us>
+	void operator()(Us&&...args) {
+		state->store(forward_m(args)...);
+		if (!state->wheel->pending(state->timer)) {
+			state->schedule();
+		}
+	}
+};
+
+/*
+	\brief	每个操作提供
+				output<Ts...>		以参数Ts...(已经decay)调用时向下游发出的参数类型,为Seq
+				stage(Seq<Ts...>, next)	构造调用next的阶段
+*/
+template<class Pred>
+struct FilterOp {
+	Pred pred;
+	template<class...Ts>
+	using output = Seq<Ts...>;
+	template<class...Ts,class Next>
+	auto stage(Seq<Ts...>, Next&& next)const {
+		return FilterStage<Pred, std::decay_t<Next>>{ pred, forward_m(next) };
+	}
+};
+template<class F>
+struct MapOp {
+	F func;
+	template<class...Ts>
+	using output = Seq<std::decay_t<decltype(std::declval<F&>()(std::declval<Ts&>()...))>>;
+	template<class...Ts,class Next>
+	auto stage(Seq<Ts...>, Next&& next)const {
+		return MapStage<F, std::decay_t<Next>>{ func, forward_m(next) };
+	}
+};
+template<class Pred>
+struct TakeWhileOp {
+	Pred pred;
+	template<class...Ts>
+	using output = Seq<Ts...>;
+	template<class...Ts,class Next>
+	auto stage(Seq<Ts...>, Next&& next)const {
+		return TakeWhileStage<Pred, std::decay_t<Next>>{ pred, forward_m(next) };
+	}
+};
+struct BufferOp {
+	std::size_t count;
+	template<class...Ts>
+	using elem = std::conditional_t<sizeof...(Ts) == 1, Head_s<Seq<Ts...>>, std::tuple<Ts...>>;
+	template<class...Ts>
+	using output = Seq<std::vector<elem<Ts...>>>;
+	template<class...Ts,class Next>
+	auto stage(Seq<Ts...>, Next&& next)const {
+		return BufferStage<elem<Ts...>, std::decay_t<Next>>{ count, forward_m(next), {} };
+	}
+};
+template<class Wheel>
+struct DebounceOp {
+	Wheel* wheel;
+	typename Wheel::duration delay;
+	template<class...Ts>
+	using output = Seq<Ts...>;
+	template<class...Ts,class Next>
+	auto stage(Seq<Ts...>, Next&& next)const {
+		using State = SignalOpsImp::TimedState<Wheel, std::decay_t<Next>, Ts...>;
+		return DebounceStage<Wheel, std::decay_t<Next>, Ts...>{
+			std::make_shared<State>(*wheel, delay, std::decay_t<Next>(forward_m(next))) };
+	}
+};
+template<class Wheel>
+struct SampleOp {
+	Wheel* wheel;
+	typename Wheel::duration period;
+	template<class...Ts>
+	using output = Seq<Ts...>;
+	template<class...Ts,class Next>
+	auto stage(Seq<Ts...>, Next&& next)const {
+		using State = SignalOpsImp::TimedState<Wheel, std::decay_t<Next>, Ts...>;
+		return SampleStage<Wheel, std::decay_t<Next>, Ts...>{
+			std::make_shared<State>(*wheel, period, std::decay_t<Next>(forward_m(next))) };
+	}
+};
+
+/*
+	\brief	只转发pred(args...)为真的事件
+*/
+template<class Pred>
+FilterOp<std::decay_t<Pred>> filter(Pred&& pred) {
+	return { forward_m(pred) };
+}
+/*
+	\brief	以func(args...)的结果作为唯一的参数转发
+*/
+template<class F>
+MapOp<std::decay_t<F>> map(F&& func) {
+	return { forward_m(func) };
+}
+/*
+	\brief	转发事件直到pred第一次为假,此后丢弃所有的事件
+*/
+template<class Pred>
+TakeWhileOp<std::decay_t<Pred>> take_while(Pred&& pred) {
+	return { forward_m(pred) };
+}
+/*
+	\brief	每攒够count个事件以const std::vector<T>&发出一次,
+			多个参数的事件保存为std::tuple
+*/
+inline BufferOp buffer(std::size_t count) {
+	return { count == 0 ? 1 : count };
+}
+/*
+	\brief	事件停止delay之后才发出其中最后一个
+	\note	以wheel计时,wheel必须比连接活得更久
+*/
+template<class Wheel,class Rep,class Period>
+DebounceOp<Wheel> debounce(Wheel& wheel, std::chrono::duration<Rep, Period> delay) {
+	return { &wheel, std::chrono::duration_cast<typename Wheel::duration>(delay) };
+}
+/*
+	\brief	第一个事件之后每隔period发出这期间最新的一个,没有新的事件时停止计时
+	\note	以wheel计时,wheel必须比连接活得更久
+*/
+template<class Wheel,class Rep,class Period>
+SampleOp<Wheel> sample(Wheel& wheel, std::chrono::duration<Rep, Period> period) {
+	return { &wheel, std::chrono::duration_cast<typename Wheel::duration>(period) };
+}
+
+/*
+	\brief	按顺序组合的操作
+*/
+template<class...Ops>
+struct OpChain {
+	std::tuple<Ops...> ops;
+
+private:
+	template<std::size_t I,class Sink,class...Ts>
+	auto build(Sink&& sink, Seq<Ts...>, std::true_type)const {
+		return std::decay_t<Sink>(forward_m(sink));
+	}
+	template<std::size_t I,class Sink,class...Ts>
+	auto build(Sink&& sink, Seq<Ts...> in, std::false_type)const {
+		using Op = std::tuple_element_t<I, std::tuple<Ops...>>;
+		using Out = typename Op::template output<Ts...>;
+		auto next = build<I + 1>(forward_m(sink), Out{},
+			std::integral_constant<bool, I + 1 == sizeof...(Ops)>{});
+		return std::get<I>(ops).stage(in, std::move(next));
+	}
+public:
+	/*
+		\brief	与sink融合成一个函数对象,以Ts...调用(Ts为decay之后的类型)
+		\note	每次bind都得到独立的状态(如take_while的开关,buffer中的事件)
+	*/
+	template<class...Ts,class Sink>
+	auto bind(Seq<Ts...> in, Sink&& sink)const {
+		return build<0>(forward_m(sink), in, std::integral_constant<bool, sizeof...(Ops) == 0>{});
+	}
+};
+
+template<class Pred>
+struct IsSignalOpImp<FilterOp<Pred>> :std::true_type {};
+template<class F>
+struct IsSignalOpImp<MapOp<F>> :std::true_type {};
+template<class Pred>
+struct IsSignalOpImp<TakeWhileOp<Pred>> :std::true_type {};
+template<>
+struct IsSignalOpImp<BufferOp> :std::true_type {};
+template<class Wheel>
+struct IsSignalOpImp<DebounceOp<Wheel>> :std::true_type {};
+template<class Wheel>
+struct IsSignalOpImp<SampleOp<Wheel>> :std::true_type {};
+template<class...Ops>
+struct IsSignalOpImp<OpChain<Ops...>> :std::true_type {};
+
+template<class...Ops>
+OpChain<Ops...> makeOpChain(std::tuple<Ops...>&& ops) {
+	return { std::move(ops) };
+}
+template<class Op>
+OpChain<std::decay_t<Op>> toOpChain(Op&& op) {
+	return { std::make_tuple(forward_m(op)) };
+}
+template<class...Ops>
+const OpChain<Ops...>& toOpChain(OpChain<Ops...>& chain) {
+	return chain;
+}
+template<class...Ops>
+const OpChain<Ops...>& toOpChain(const OpChain<Ops...>& chain) {
+	return chain;
+}
+template<class...Ops>
+OpChain<Ops...>&& toOpChain(OpChain<Ops...>&& chain) {
+	return std::move(chain);
+}
+
+template<class L,class R,class = std::enable_if_t<IsSignalOp<L>::value && IsSignalOp<R>::value>>
+auto operator|(L&& lhs, R&& rhs) {
+	auto ops = std::tuple_cat(toOpChain(forward_m(lhs)).ops, toOpChain(forward_m(rhs)).ops);
+	return makeOpChain(std::move(ops));
+}
+
+namespace SignalOpsImp {
+	template<class T,class = void>
+	struct IsSignal :std::false_type {};
+	template<class T>
+	struct IsSignal<T, std::conditional_t<true, void, typename T::ftype>> :std::true_type {};
+
+	template<class Signature>
+	struct DecayedParams;
+	template<class R,class...Ps>
+	struct DecayedParams<R(Ps...)> {
+		using type = Seq<std::decay_t<Ps>...>;
+	};
+
+	template<class Dst>
+	SignalSink<Dst> makeSink(Dst& dst, std::true_type) {
+		return { &dst };
+	}
+	template<class Dst>
+	std::decay_t<Dst> makeSink(Dst&& dst, std::false_type) {
+		return forward_m(dst);
+	}
+}
+
+/*
+	\brief	把src的事件经过ops之后发给dst,dst为信号(以引用保存)或函数对象(复制)
+	\param	src 参数类型由其ftype(如SimpleSignal的签名)决定的信号
+	\return	src.connect的结果,断开它即断开整条链
+*/
+template<class Src,class Ops,class Dst,class = std::enable_if_t<IsSignalOp<Ops>::value>>
+auto pipe(Src& src, Ops&& ops, Dst&& dst) {
+	using Params = typename SignalOpsImp::DecayedParams<typename Src::ftype>::type;
+	using IsSig = SignalOpsImp::IsSignal<std::decay_t<Dst>>;
+	return src.connect(toOpChain(forward_m(ops)).bind(Params{},
+		SignalOpsImp::makeSink(forward_m(dst), std::integral_constant<bool, IsSig::value && std::is_lvalue_reference<Dst>::value>{})));
+}
+
+}//namespace Talg
+
+#include "undef_macro.h"
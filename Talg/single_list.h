@@ -7,6 +7,7 @@ class SingleList:private std::forward_list<T,Allocator> {
 public:
 	using Base = std::forward_list<T, Allocator>;
 	using Base::Base;
+	using allocator_type	=Allocator;
 	using value_type		=typename Base::value_type;
 	using size_type			=typename Base::size_type;
 	using difference_typ	=typename Base::difference_type;
@@ -53,6 +54,9 @@ public:
 		noexcept(std::is_nothrow_default_constructible<Base>::value)
 		:Base(),last(before_begin())
 	{}
+	explicit SingleList(const Allocator& alloc)noexcept
+		:Base(alloc),last(before_begin())
+	{}
 	SingleList(SingleList&& rhs)noexcept(std::is_nothrow_move_constructible<Base>::value)
 		:Base(std::move(rhs)),last(rhs.last){}
 
@@ -100,7 +104,7 @@ public:
 	
 	iterator insert_after(const_iterator pos, const T& value) {
 		if(pos!=last){
-			return Base::insert_after(last, value);
+			return Base::insert_after(pos, value);
 		} else {
 			push_back(value);
 			return last;
@@ -108,7 +112,7 @@ public:
 	}
 	iterator insert_after(const_iterator pos, T&& value) {
 		if(pos!=last){
-			return Base::insert_after(last, std::move(value));
+			return Base::insert_after(pos, std::move(value));
 		} else {
 			push_back(std::move(value));
 			return last;
@@ -136,6 +140,14 @@ public:
 		}
 		return *res;
 	}
+	template<class...Ts>
+	iterator emplace_after(const_iterator pos, Ts&&... args) {
+		auto iter = Base::emplace_after(pos, std::forward<Ts>(args)...);
+		if (pos == last) {
+			last = iter;
+		}
+		return iter;
+	}
 	template< class... Ts >
 	reference emplace_back(Ts&&... args) {
 		auto iter = Base::emplace_after(last, std::forward<Ts>(args)...);
@@ -152,7 +164,7 @@ public:
 	{
 		if (last == begin()) {
 			Base::pop_front();
-			last = this->before_beign();
+			last = this->before_begin();
 		} else {
 			Base::pop_front();
 		}
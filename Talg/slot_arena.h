@@ -0,0 +1,200 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include "slotlist.h"
+#include "basic_macro_impl.h"
+
+namespace Talg {
+
+/*
+	\brief	供许多信号共用的内存池,用于槽的链表节点,State以及放不进SmallFunction缓冲区的函数对象.
+			小块内存按16字节为一级分成若干种大小,释放后放入对应的空闲链表供再次分配;
+			其余的从固定大小的内存块中顺序切出,大块内存单独占用一个内存块.
+	\note	不是线程安全的,一个内存池应当只由一个子系统(线程)使用.
+			release一次性释放所有的内存块,调用之前所有使用它的信号与连接都必须已经析构
+			(析构本身只是把内存放回空闲链表,代价很小).
+			大块内存在release之前不会被重用.
+*/
+class SlotArena {
+	static constexpr std::size_t granule = alignof(std::max_align_t) < 16 ? 16 : alignof(std::max_align_t);
+	static constexpr std::size_t max_small = 512;
+	static constexpr std::size_t classes = max_small / granule;
+
+	struct Block {
+		Block* next;
+	};
+	struct FreeNode {
+		FreeNode* next;
+	};
+	static constexpr std::size_t header = (sizeof(Block) + granule - 1) / granule * granule;
+
+	Block* blocks_ = nullptr;
+	char* cur_ = nullptr;
+	char* end_ = nullptr;
+	FreeNode* free_[classes] = {};
+	std::size_t block_size_;
+	std::size_t reserved_ = 0;
+	std::size_t in_use_ = 0;
+
+	static std::size_t roundUp(std::size_t bytes)noexcept {
+		return bytes == 0 ? granule : (bytes + granule - 1) / granule * granule;
+	}
+	char* newBlock(std::size_t bytes) {
+		auto raw = static_cast<char*>(::operator new(header + bytes));
+		auto block = reinterpret_cast<Block*>(raw);
+		block->next = blocks_;
+		blocks_ = block;
+		reserved_ += header + bytes;
+		return raw + header;
+	}
+public:
+	explicit SlotArena(std::size_t block_size = 64 * 1024)
+		:block_size_(roundUp(block_size < 4 * max_small ? 4 * max_small : block_size))
+	{
+
+	}
+	SlotArena(const SlotArena&) = delete;
+	SlotArena& operator=(const SlotArena&) = delete;
+	~SlotArena() {
+		release();
+	}
+
+	/*
+		\brief	分配bytes字节,对齐要求不能超过alignof(std::max_align_t)
+	*/
+	void* allocate(std::size_t bytes, std::size_t align = alignof(std::max_align_t)) {
+		if (align > granule) {
+			throw std::bad_alloc();
+		}
+		std::size_t size = roundUp(bytes);
+		in_use_ += size;
+		if (size > max_small) {
+			if (size > block_size_ / 4) {
+				return newBlock(size);
+			}
+		} else if (auto& head = free_[size / granule - 1]) {
+			auto node = head;
+			head = node->next;
+			return node;
+		}
+		if (static_cast<std::size_t>(end_ - cur_) < size) {
+			//剩下的部分不足以满足这次分配,直接丢弃
+			cur_ = newBlock(block_size_);
+			end_ = cur_ + block_size_;
+		}
+		auto ptr = cur_;
+		cur_ += size;
+		return ptr;
+	}
+	void deallocate(void* ptr, std::size_t bytes, std::size_t = alignof(std::max_align_t))noexcept {
+		if (ptr == nullptr) {
+			return;
+		}
+		std::size_t size = roundUp(bytes);
+		in_use_ -= size;
+		if (size <= max_small) {
+			auto node = static_cast<FreeNode*>(ptr);
+			node->next = free_[size / granule - 1];
+			free_[size / granule - 1] = node;
+		}
+	}
+	/*
+		\brief	释放所有的内存块
+	*/
+	void release()noexcept {
+		while (blocks_ != nullptr) {
+			auto next = blocks_->next;
+			::operator delete(blocks_);
+			blocks_ = next;
+		}
+		cur_ = end_ = nullptr;
+		for (auto& head : free_) {
+			head = nullptr;
+		}
+		reserved_ = in_use_ = 0;
+	}
+	/*
+		\brief	从系统申请的字节数
+	*/
+	std::size_t bytes_reserved()const noexcept {
+		return reserved_;
+	}
+	/*
+		\brief	已经分配且尚未释放的字节数(按16字节取整)
+	*/
+	std::size_t bytes_in_use()const noexcept {
+		return in_use_;
+	}
+};
+
+/*
+	\brief	从SlotArena分配的分配器,可以由SlotArena&隐式构造.
+			默认构造时不关联内存池,此时使用全局的operator new.
+	\note	两个分配器关联同一个内存池时相等.
+*/
+template<class T>
+class ArenaAllocator {
+	SlotArena* arena_ = nullptr;
+public:
+	using value_type = T;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+
+	ArenaAllocator() = default;
+	ArenaAllocator(SlotArena& arena)noexcept
+		:arena_(&arena)
+	{
+
+	}
+	template<class U>
+	ArenaAllocator(const ArenaAllocator<U>& rhs)noexcept
+		:arena_(rhs.arena())
+	{
+
+	}
+
+	T* allocate(std::size_t n) {
+		if (arena_ == nullptr) {
+			return static_cast<T*>(::operator new(n * sizeof(T)));
+		}
+		return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+	}
+	void deallocate(T* ptr, std::size_t n)noexcept {
+		if (arena_ == nullptr) {
+			::operator delete(ptr);
+		} else {
+			arena_->deallocate(ptr, n * sizeof(T), alignof(T));
+		}
+	}
+	SlotArena* arena()const noexcept {
+		return arena_;
+	}
+
+	template<class U>
+	bool operator==(const ArenaAllocator<U>& rhs)const noexcept {
+		return arena_ == rhs.arena();
+	}
+	template<class U>
+	bool operator!=(const ArenaAllocator<U>& rhs)const noexcept {
+		return arena_ != rhs.arena();
+	}
+};
+
+/*
+	\brief	链表节点与State都从SlotArena分配的槽特性
+*/
+template<class Functor,template<class...>class Container = SingleList>
+using ArenaSlotTraits = DefaultSlotTraits<Functor, Container, ArenaAllocator<void>>;
+
+/*
+	\brief	槽的所有内存都来自SlotArena的信号:函数对象为SmallFunction,
+			不超过Capacity字节的直接保存在节点中,更大的也从同一个内存池分配.
+			以SlotArena构造,如 ArenaSignal<void(int)> sig(arena);
+*/
+template<class Signature,std::size_t Capacity = 48>
+using ArenaSignal = SimpleSignal<Signature, ArenaSlotTraits<SmallFunction<Signature, Capacity>>>;
+
+}//namespace Talg
+
+#include "undef_macro.h"
@@ -2,6 +2,9 @@
 #include "iter_call_cache.h"
 #include <functional>
 #include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <utility>
 
 namespace Talg{
 template<class GetParram,class Cache,class Iterator>
@@ -79,6 +82,71 @@ auto makeSlotIter(const Iter& iter, T& get_param,T2& cache) {
 }
 
 
+/*
+	\brief	以下标遍历连续存储的槽,下标可以为-1从而充当before_begin,
+			使得以前驱为基准的SlotCallIterator也能用于vector之类的容器.
+	\param	Range	支持operator[]及size()的容器,其元素可以是槽本身也可以是指向槽的指针.
+	\note	只提供SlotCallIterator所需要的操作,并不是完整的随机访问迭代器.
+*/
+template<class Range>
+class IndexSlotIterator {
+	using element_type	= decltype(std::declval<Range&>()[0]);
+	using is_ptr		= std::is_pointer<std::remove_reference_t<element_type>>;
+	template<class T>
+	static T& deref(T& val,std::false_type)noexcept { return val; }
+	template<class T>
+	static T& deref(T* ptr,std::true_type)noexcept { return *ptr; }
+public:
+	using reference			= decltype(deref(std::declval<element_type>(),is_ptr{}));
+	using value_type		= std::remove_reference_t<reference>;
+	using pointer			= value_type*;
+	using difference_type	= std::ptrdiff_t;
+	using iterator_category = std::forward_iterator_tag;
+private:
+	Range* range_;
+	difference_type id_;
+public:
+	IndexSlotIterator(Range& range,difference_type id)noexcept
+		:range_(std::addressof(range)),id_(id){}
+
+	reference operator*()const {
+		return deref((*range_)[static_cast<std::size_t>(id_)],is_ptr{});
+	}
+	pointer operator->()const {
+		return std::addressof(**this);
+	}
+	IndexSlotIterator& operator++()noexcept {
+		++id_;
+		return *this;
+	}
+	IndexSlotIterator operator++(int)noexcept {
+		IndexSlotIterator old = *this;
+		++id_;
+		return old;
+	}
+	difference_type index()const noexcept {
+		return id_;
+	}
+	friend bool operator==(const IndexSlotIterator& lhs, const IndexSlotIterator& rhs)noexcept {
+		return lhs.id_ == rhs.id_;
+	}
+	friend bool operator!=(const IndexSlotIterator& lhs, const IndexSlotIterator& rhs)noexcept {
+		return lhs.id_ != rhs.id_;
+	}
+};
+
+/*
+	\brief	生成[before_begin,before_end]这对迭代器,用于以SlotCallIterator遍历range
+	\return	std::pair,first为before_begin,second为before_end
+*/
+template<class Range>
+auto makeIndexSlotRange(Range& range)noexcept {
+	using Iter = IndexSlotIterator<Range>;
+	using diff = typename Iter::difference_type;
+	return std::make_pair(Iter(range, -1), Iter(range, static_cast<diff>(range.size()) - 1));
+}
+
+
 
 template<class GetParram,class Cache,class Iterator>
 class CheckCallIterator:public SlotCallIterator<GetParram,Cache,Iterator>{
@@ -117,5 +185,49 @@ public:
 	}
 };
 
+/*
+	\brief	遍历时顺便断开已经调用过(或被跳过)的失效的槽的SlotCallIterator,
+			当前节点被断开时迭代器停在原来的前驱上,因此与其他迭代器的比较不受影响.
+	\param	Unlinker 提供iterator类型及bool unlinkNext(const iterator& prev),
+			后者断开prev之后的节点时返回true.
+	\note	node_与prev_同步前进,用于在prev_为const_iterator时仍能修改链表,
+			unlinker为nullptr时与SlotCallIterator相同.
+*/
+template<class GetParram,class Cache,class Iterator,class Unlinker>
+class PurgeCallIterator:public SlotCallIterator<GetParram,Cache,Iterator>{
+	using Base = SlotCallIterator<GetParram, Cache, Iterator>;
+	using node_iterator = typename Unlinker::iterator;
+	node_iterator node_;
+	Unlinker* unlinker_;
+public:
+	PurgeCallIterator(const Base& rhs,const node_iterator& node,Unlinker* unlinker)
+		noexcept(std::is_nothrow_copy_constructible<Base>::value
+			  && std::is_nothrow_copy_constructible<node_iterator>::value)
+		:Base(rhs),node_(node),unlinker_(unlinker){}
+
+	PurgeCallIterator& operator++()
+	{
+		if (unlinker_ != nullptr && unlinker_->unlinkNext(node_)) {
+			Base::cache.get().reset();
+		} else {
+			Base::operator++();
+			++node_;
+		}
+		return *this;
+	}
+	
+	PurgeCallIterator operator++(int)
+	{
+		PurgeCallIterator old = *this;
+		++(*this);
+		return old;
+	}
+};
+
+template<class Iter,class GetParram,class Cache,class Iterator,class Unlinker>
+auto makePurgeIter(const SlotCallIterator<GetParram, Cache, Iterator>& iter, const Iter& node, Unlinker* unlinker) {
+	return PurgeCallIterator<GetParram, Cache, Iterator, Unlinker>{ iter, node, unlinker };
+}
+
 }//namespace Talg
 
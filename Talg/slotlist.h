@@ -1,9 +1,15 @@
 ﻿#pragma once
 #include "single_list.h"
+#include "chunk_list.h"
+#include "small_function.h"
 #include "signal_wrapper.h"
 #include "has_member.h"
 #include "slot_iterator.h"
+#include "type_traits.h"
+#include "optional.h"
+#include <memory>
 #include <type_traits>
+#include <vector>
 #include "basic_macro_impl.h"
 
 namespace Talg {
@@ -67,7 +73,80 @@ public:
 
 
 
+/*
+	\brief	将函数对象类型Functor换成签名为Signature的版本.
+			Functor提供成员模板rebind时(如SmallFunction)优先使用它,
+			否则以ReplaceParam替换模板参数(只适用于只有类型参数的模板).
+*/
+template<class Functor,class Signature,class=void>
+struct RebindFunctorImp {
+	using type = ReplaceParam<Functor, Signature>;
+};
+template<class Functor,class Signature>
+struct RebindFunctorImp<Functor, Signature, void_t<typename Functor::template rebind<Signature>>> {
+	using type = typename Functor::template rebind<Signature>;
+};
+template<class Functor,class Signature>
+using RebindFunctor = typename RebindFunctorImp<Functor, Signature>::type;
+
+/*
+	\brief	函数对象是否提供expired(),提供时expired()为true的槽不再被调用,
+			并在最外层的emit遍历经过它时被断开,见TrackedFunction.
+*/
+template<class Functor,class=void>
+struct HasExpired :std::false_type {};
 template<class Functor>
+struct HasExpired<Functor, void_t<decltype(std::declval<const Functor&>().expired())>> :std::true_type {};
+
+template<class Functor>
+bool isExpiredSlot(const Functor& func, std::true_type)noexcept {
+	return func.expired();
+}
+template<class Functor>
+constexpr bool isExpiredSlot(const Functor&, std::false_type)noexcept {
+	return false;
+}
+
+template<class Alloc>
+struct IsStdAllocator :std::false_type {};
+template<class T>
+struct IsStdAllocator<std::allocator<T>> :std::true_type {};
+
+/*
+	\brief	以分配器释放对象的删除器,用于以分配器分配的State
+*/
+template<class Alloc>
+struct AllocDeleter {
+	using Traits = std::allocator_traits<Alloc>;
+	Alloc alloc;
+	void operator()(typename Traits::value_type* ptr) {
+		Traits::destroy(alloc, ptr);
+		Traits::deallocate(alloc, ptr, 1);
+	}
+};
+
+/*
+	\brief	Allocator为std::allocator时为Container<T>,否则为Container<T,Allocator<T>>,
+			从而只有一个模板参数的容器仍然可以用于默认的分配器
+*/
+template<template<class...>class Container,class T,class Alloc,bool = IsStdAllocator<Alloc>::value>
+struct SelectSlotContainer {
+	using type = Container<T>;
+};
+template<template<class...>class Container,class T,class Alloc>
+struct SelectSlotContainer<Container, T, Alloc, false> {
+	using type = Container<T, typename std::allocator_traits<Alloc>::template rebind_alloc<T>>;
+};
+
+/*
+	\brief	槽的默认特性
+	\param	Functor 槽的函数对象类型,Container 保存槽的单向链表
+			(要求提供与SingleList一致的接口,如SingleList及ChunkList),
+			Allocator 链表节点及State的分配器(会被rebind),不是std::allocator时
+			Container必须接受分配器作为第二个模板参数,
+			并且Functor可以以(std::allocator_arg,alloc,func)构造时(如SmallFunction)也以它分配函数对象.
+*/
+template<class Functor,template<class...>class Container=SingleList,class Allocator=std::allocator<void>>
 struct DefaultSlotTraits {
 
 	/*
@@ -77,10 +156,10 @@ struct DefaultSlotTraits {
 				同时也是为了方便更换function而不需要改变slottraits的实现.
 		\param	T真正的类型,一般情况下Functor就是std::function<T>,rebind之后也一样,
 				对于某些特殊情况原本Functor是std::function<void>,rebind之后变成function<T>
-		\require	要么是DefaultSlotTraits本身要么是DefaultSlotTraits<ReplaceParam<Functor, T>>;
+		\require	要么是DefaultSlotTraits本身要么是DefaultSlotTraits<RebindFunctor<Functor, T>>;
 	*/
 	template<class T>
-	using rebind = DefaultSlotTraits<ReplaceParam<Functor, T>>;
+	using rebind = DefaultSlotTraits<RebindFunctor<Functor, T>, Container, Allocator>;
 
 	enum SlotState:char{
 		free=0,discon=2,blocked=4,locked=8
@@ -90,6 +169,7 @@ struct DefaultSlotTraits {
 	struct SlotType : Functor {
 		using Base = Functor;
 		State* state;
+		mutable bool busy = false;	//正在被collect_guarded调用,嵌套的collect_guarded会跳过它
 		template<class...Ts>
 		SlotType(State* s, Ts&&...args)
 			: Base(forward_m(args)...),state(s)
@@ -104,7 +184,7 @@ struct DefaultSlotTraits {
 		bool is_callable()const noexcept;
 		~SlotType();
 	};
-	using container = SingleList<SlotType>;
+	using container = typename SelectSlotContainer<Container, SlotType, Allocator>::type;
 	using iterator = typename container::iterator;
 	using const_iterator = typename container::const_iterator;
 	
@@ -162,6 +242,9 @@ struct DefaultSlotTraits {
 			if (state == blocked || state == locked || state == discon) {
 				return state;
 			}
+			if (std::next(prev_node_)->busy) {
+				return locked;	//正在collect_guarded中被调用,与locked一样不可断开
+			}
 			if (state != discon) {
 				ref->erase_after(prev_node_);
 				iterator old = prev_node_++;	//此处使用auto时曾经引发未知的MSVC的bug
@@ -186,12 +269,54 @@ struct DefaultSlotTraits {
 		}
 	};
 	
-	using Connection = std::unique_ptr<State>;
+	using StateAlloc = typename std::allocator_traits<Allocator>::template rebind_alloc<State>;
+	using Connection = std::conditional_t<IsStdAllocator<Allocator>::value,
+		std::unique_ptr<State>,
+		std::unique_ptr<State, AllocDeleter<StateAlloc>>>;
 	using SharedConnection = std::shared_ptr<State>;
 
+	/*
+		\brief	构造新的槽并追加到list的末尾,BasicSignal::connect经由此处建立连接,
+				从而使其他的特性可以改变State的存放方式.
+		\return	该槽的连接
+	*/
+	template<class...Ts>
+	static Connection connectSlot(container& list, Ts&&...func) {
+		auto con = makeState(list, IsStdAllocator<Allocator>{});
+		using UsesAllocator = std::integral_constant<bool, !IsStdAllocator<Allocator>::value &&
+			std::is_constructible<Functor, std::allocator_arg_t, const Allocator&, Ts&&...>::value>;
+		emplaceSlot(list, con.get(), UsesAllocator{}, forward_m(func)...);
+		return con;
+	}
+	static Connection makeState(container& list, std::true_type) {
+		return std::make_unique<State>(list.before_end(), list);
+	}
+	//State与槽来自同一个分配器
+	static Connection makeState(container& list, std::false_type) {
+		using Traits = std::allocator_traits<StateAlloc>;
+		StateAlloc alloc(list.get_allocator());
+		auto ptr = Traits::allocate(alloc, 1);
+		try {
+			Traits::construct(alloc, std::addressof(*ptr), list.before_end(), list);
+		}
+		catch (...) {
+			Traits::deallocate(alloc, ptr, 1);
+			throw;
+		}
+		return Connection(std::addressof(*ptr), AllocDeleter<StateAlloc>{ alloc });
+	}
+	template<class...Ts>
+	static void emplaceSlot(container& list, State* state, std::false_type, Ts&&...func) {
+		list.emplace_back(state, forward_m(func)...);
+	}
+	template<class...Ts>
+	static void emplaceSlot(container& list, State* state, std::true_type, Ts&&...func) {
+		list.emplace_back(state, std::allocator_arg, Allocator(list.get_allocator()), forward_m(func)...);
+	}
+
 	struct DefaultResCombiner {
-		template<class Iter,class Container>
-		decltype(auto) operator()(Iter first,Iter last,const Container&) {
+		template<class Iter,class Signal>
+		decltype(auto) operator()(Iter first,Iter last,const Signal&) {
 			for (; first != last ; ++first) {
 				if (!first){
 					continue;
@@ -201,14 +326,14 @@ struct DefaultSlotTraits {
 		}
 	};
 };
-template<class Functor>
- DefaultSlotTraits<Functor>::SlotType::~SlotType() {
+template<class Functor,template<class...>class Container,class Allocator>
+DefaultSlotTraits<Functor,Container,Allocator>::SlotType::~SlotType() {
 	if (state != nullptr) {
 		state->state = discon;
 	}
 }
-template<class Functor>
-auto DefaultSlotTraits<Functor>::SlotType::lock(State& other){
+template<class Functor,template<class...>class Container,class Allocator>
+auto DefaultSlotTraits<Functor,Container,Allocator>::SlotType::lock(State& other){
 	assert(
 		state==nullptr || (!(state->is_blocked()) && state->is_connected())
 	);
@@ -226,12 +351,30 @@ auto DefaultSlotTraits<Functor>::SlotType::lock(State& other){
 	return std::unique_ptr<State, decltype(when_exit)> ( state, when_exit );
 }
 
-template<class Functor>
-bool DefaultSlotTraits<Functor>::SlotType::is_callable()const noexcept {
-	return state == nullptr || state->state == free;
+template<class Functor,template<class...>class Container,class Allocator>
+bool DefaultSlotTraits<Functor,Container,Allocator>::SlotType::is_callable()const noexcept {
+	return !busy && (state == nullptr || state->state == free)
+		&& !isExpiredSlot(static_cast<const Functor&>(*this), HasExpired<Functor>{});
 }
 
 
+/*
+	\brief	丢弃所有结果的可并行组合器,用于BasicSignal::emit_parallel
+*/
+struct DiscardCombiner {
+	static constexpr bool is_associative = true;
+	bool init()const noexcept {
+		return true;
+	}
+	template<class T>
+	bool fold(bool acc, T&&)const noexcept {
+		return acc;
+	}
+	bool merge(bool lhs, bool)const noexcept {
+		return lhs;
+	}
+};
+
 template<class Signature,
 		 class SlotTrait=DefaultSlotTraits<EqualableFunction<Signature>>
 >
@@ -250,8 +393,124 @@ public:
 	using container = typename SlotTrait::container;
 	using iterator = typename container::iterator;
 	using const_iterator = typename container::const_iterator;
-private:
+protected:
 	container slot_list;
+private:
+	std::size_t emit_depth_ = 0;
+
+	//在作用域内对一个计数器加一或把一个标志置为true
+	template<class T>
+	struct ScopedMark {
+		T& val;
+		T old;
+		explicit ScopedMark(T& v)noexcept :val(v), old(v) {
+			val = static_cast<T>(old + 1);
+		}
+		~ScopedMark() {
+			val = old;
+		}
+	};
+
+	using IsTracked = HasExpired<typename SlotType::Base>;
+	//正在被调用的槽留到以后
+	static bool isRemovable(const SlotType& slot)noexcept {
+		bool running = slot.busy || (slot.state != nullptr && slot.state->state == SlotTrait::locked);
+		return !running && isExpiredSlot(static_cast<const typename SlotType::Base&>(slot), IsTracked{});
+	}
+	//断开prev之后的节点,返回被断开节点的下一个节点
+	iterator unlinkAfter(const iterator& prev)noexcept {
+		auto iter = slot_list.erase_after(prev);
+		if (iter != slot_list.end() && iter->state != nullptr) {
+			iter->state->prev_node_ = prev;
+		}
+		return iter;
+	}
+	std::size_t purgeExpired(std::false_type)noexcept {
+		return 0;
+	}
+	std::size_t purgeExpired(std::true_type) {
+		std::size_t count = 0;
+		auto prev = slot_list.before_begin();
+		auto iter = slot_list.begin();
+		while (iter != slot_list.end()) {
+			if (isRemovable(*iter)) {
+				iter = unlinkAfter(prev);
+				++count;
+			} else {
+				prev = iter;
+				++iter;
+			}
+		}
+		return count;
+	}
+
+	/*
+		最外层的emit在遍历的同时断开目标已经析构的槽,因此带有跟踪的信号每次emit只遍历一次链表.
+		嵌套的emit中不能删除节点,因为外层的迭代器可能正指向它们.
+		结束迭代器以emit开始时的最后一个节点为基准,所以它即使失效也要等到遍历结束之后再断开.
+	*/
+	class ExpiredPurger {
+	public:
+		using iterator = typename BasicSignal::iterator;
+	private:
+		BasicSignal& sig_;
+		const_iterator last_;
+		iterator before_last_;
+		bool last_expired_ = false;
+	public:
+		ExpiredPurger(BasicSignal& sig, const const_iterator& last)noexcept
+			:sig_(sig), last_(last), before_last_(){}
+		ExpiredPurger(const ExpiredPurger&) = delete;
+		ExpiredPurger& operator=(const ExpiredPurger&) = delete;
+		bool unlinkNext(const iterator& prev)noexcept {
+			auto iter = std::next(prev);
+			if (!isRemovable(*iter)) {
+				return false;
+			}
+			if (const_iterator(iter) == last_) {
+				before_last_ = prev;
+				last_expired_ = true;
+				return false;
+			}
+			sig_.unlinkAfter(prev);
+			return true;
+		}
+		~ExpiredPurger() {
+			if (last_expired_) {
+				sig_.unlinkAfter(before_last_);
+			}
+		}
+	};
+
+	/*
+		\brief	生成遍历[before_beg,before_end]的一对迭代器,跟踪的信号在最外层的emit中
+				还会断开遍历经过的失效的槽,此时purger不为空
+	*/
+	template<class Getter,class Cache,class Iter>
+	auto makeWalk(const Iter& before_beg, const Iter& before_end, Getter& getter, Cache& cache,
+		optional<ExpiredPurger>&, std::false_type)noexcept
+	{
+		return std::make_pair(makeSlotIter<R>(before_beg, getter, cache), makeSlotIter<R>(before_end, getter, cache));
+	}
+	template<class Getter,class Cache,class Iter>
+	auto makeWalk(const Iter& before_beg, const Iter& before_end, Getter& getter, Cache& cache,
+		optional<ExpiredPurger>& purger, std::true_type)
+	{
+		//只有从头开始的遍历才能得到与before_beg同步的可修改的迭代器
+		if (emit_depth_ == 1 && const_iterator(before_beg) == slot_list.cbefore_begin()) {
+			purger.emplace(*this, before_end);
+		}
+		ExpiredPurger* unlinker = purger ? &*purger : nullptr;
+		return std::make_pair(
+			makePurgeIter(makeSlotIter<R>(before_beg, getter, cache), slot_list.before_begin(), unlinker),
+			makePurgeIter(makeSlotIter<R>(before_end, getter, cache), slot_list.before_end(), unlinker));
+	}
+	template<class Getter,class Cache,class Iter>
+	auto makeWalk(const Iter& before_beg, const Iter& before_end, Getter& getter, Cache& cache,
+		optional<ExpiredPurger>& purger)
+	{
+		return makeWalk(before_beg, before_end, getter, cache, purger, IsTracked{});
+	}
 public:
 	using Connection = typename SlotTrait::Connection;
 	using SharedConnection = typename SlotTrait::SharedConnection;
@@ -260,14 +519,21 @@ public:
 	BasicSignal()
 	:slot_list(){
 
+	}
+	/*
+		\brief	以分配器(或可以转换为分配器的对象)构造保存槽的容器,见DefaultSlotTraits
+	*/
+	template<class Alloc,
+			 class = std::enable_if_t<!std::is_base_of<BasicSignal, std::decay_t<Alloc>>::value
+								   && std::is_constructible<container, Alloc&&>::value>>
+	explicit BasicSignal(Alloc&& alloc)
+	:slot_list(forward_m(alloc)){
+
 	}
 
 	template<class... Ts>
 	Connection connect(Ts&&... func) {
-		//Connection res{ slot_list.before_end(),slot_list };
-		auto con = std::make_unique<State>(slot_list.before_end(), slot_list);
-		slot_list.emplace_back(con.get(),forward_m(func)...);
-		return con;
+		return SlotTrait::connectSlot(slot_list, forward_m(func)...);
 	}
 
 
@@ -297,6 +563,7 @@ public:
 	template<class ResCombiner,class Cache,class Iter,class...Ts>
 	decltype(auto) call(ResCombiner&& res_collector,Cache& cache,const Iter& before_beg,const Iter& before_end, Ts&&...args) 
 	{
+		ScopedMark<std::size_t> depth(emit_depth_);
 		auto getter=[&args...](Cache& cache,const Iter& iter)->typename Cache::reference_type
 			{
 				if (!cache) {
@@ -304,10 +571,11 @@ public:
 				}
 				return cache.get();
 			};	
-		 
+		optional<ExpiredPurger> purger;
+		auto walk = makeWalk(before_beg, before_end, getter, cache, purger);
 		return forward_m(res_collector)(
-			makeSlotIter<R>(before_beg, getter, cache),
-			makeSlotIter<R>(before_end,getter,cache),
+			std::move(walk.first),
+			std::move(walk.second),
 			*this
 		);
 	}
@@ -324,6 +592,133 @@ public:
 
 
 
+	/*
+		\brief	以batch中的每组参数触发信号,但先让一个槽处理完整批参数再轮到下一个槽.
+		\param	res_collector 组合器协议同collect,但对迭代器解引用得到的是
+				该槽对整批参数的结果(见BatchCache),batch 元素为参数元组的范围
+		\note	槽之间的顺序仍为连接顺序,但与逐个调用operator()不同,
+				第一个槽处理完所有参数之后第二个槽才开始.
+	*/
+	template<class ResCombiner,class Batch>
+	decltype(auto) collect_batch(ResCombiner&& res_collector, const Batch& batch) {
+		BatchCache<R, Batch> cache(batch);
+		return call(forward_m(res_collector), cache,
+			slot_list.before_begin(),
+			slot_list.before_end());
+	}
+	template<class Batch>
+	void emit_batch(const Batch& batch) {
+		BatchCache<R, Batch> cache(batch);
+		call(DefaultResCombiner{}, cache,
+			slot_list.cbefore_begin(),
+			slot_list.cbefore_end());
+	}
+
+	/*
+		\brief	把当前所有可调用的槽按顺序分成若干段交给exec并行调用,
+				每段内按顺序fold各槽的结果,最后再按段的顺序merge,
+				因此只要组合器满足结合律,结果就与依次调用时相同.
+		\param	exec 执行器,要求见thread_pool.h,
+				combiner 必须声明static constexpr bool is_associative = true,
+				并提供init(),fold(acc,res),merge(lhs,rhs),其中res为CacheRes<R>::reference_type
+		\return	combiner.merge的最终结果,没有槽时为combiner.init()
+		\note	调用期间不可以修改信号(包括在槽中connect/disconnect),
+				槽会在多个线程中同时被调用,args以左值的形式共享给所有的槽.
+	*/
+	template<class Executor,class Combiner,class...Ts>
+	auto collect_parallel(Executor& exec, Combiner&& combiner, Ts&&...args) {
+		static_assert(std::decay_t<Combiner>::is_associative,
+			"combiner must be associative to be reduced in parallel.");
+		using Acc = decltype(combiner.init());
+		std::vector<const SlotType*> slots;
+		//收集的同时断开失效的槽,嵌套在emit中时不能删除节点
+		bool purge = IsTracked::value && emit_depth_ == 0;
+		auto prev = slot_list.before_begin();
+		auto iter = slot_list.begin();
+		while (iter != slot_list.end()) {
+			if (purge && isRemovable(*iter)) {
+				iter = unlinkAfter(prev);
+				continue;
+			}
+			if (iter->is_callable()) {
+				slots.push_back(&*iter);
+			}
+			prev = iter;
+			++iter;
+		}
+		if (slots.empty()) {
+			return combiner.init();
+		}
+		//段数多于线程数,使得耗时不均时也能分摊
+		std::size_t parts = (exec.concurrency() + 1) * 4;
+		parts = parts < slots.size() ? parts : slots.size();
+		std::vector<CacheRes<R>> results(slots.size());
+		std::vector<optional<Acc>> partials(parts);
+		exec.bulk_execute(parts, [&](std::size_t part) {
+			std::size_t first = slots.size()*part / parts;
+			std::size_t last = slots.size()*(part + 1) / parts;
+			Acc acc = combiner.init();
+			for (std::size_t i = first; i != last; ++i) {
+				results[i].reset(slots[i], args...);
+				acc = combiner.fold(std::move(acc), results[i].get());
+			}
+			partials[part].emplace(std::move(acc));
+		});
+		Acc res = std::move(*partials[0]);
+		for (std::size_t i = 1; i != parts; ++i) {
+			res = combiner.merge(std::move(res), std::move(*partials[i]));
+		}
+		return res;
+	}
+
+	/*
+		\brief	以exec并行地调用所有槽并丢弃结果,限制同collect_parallel
+	*/
+	template<class Executor,class...Ts>
+	void emit_parallel(Executor& exec, Ts&&...args) {
+		collect_parallel(exec, DiscardCombiner{}, forward_m(args)...);
+	}
+
+	/*
+		\brief	防止重入的collect:槽执行期间被标记为busy,在此期间嵌套的collect_guarded
+				(以及检查了迭代器的组合器)会跳过它,因此与makeLockedIter的防止循环的语义相同,
+				但每次调用只是设置槽中的一个标志,不需要构造临时的State及unique_ptr.
+		\param	同collect
+		\note	组合器应当在解引用之前检查迭代器,如同DefaultResCombiner那样.
+	*/
+	template<class ResCombiner,class...Ts>
+	decltype(auto) collect_guarded(ResCombiner&& res_collector,Ts&&...args) {
+		using Cache = CacheRes<R>;
+		using Iter = iterator;
+		ScopedMark<std::size_t> depth(emit_depth_);
+		auto getter = [&args...](Cache& cache, const Iter& iter)->typename Cache::reference_type
+		{
+			if (!cache) {
+				ScopedMark<bool> busy(iter->busy);
+				cache.reset(iter, std::forward<Ts>(args)...);
+			}
+			return cache.get();
+		};
+		Cache cache{};
+		optional<ExpiredPurger> purger;
+		auto walk = makeWalk(slot_list.before_begin(), slot_list.before_end(), getter, cache, purger);
+		return forward_m(res_collector)(
+			std::move(walk.first),
+			std::move(walk.second),
+			*this
+		);
+	}
+	template<class...Ts>
+	void emit_guarded(Ts&&...args) {
+		collect_guarded(DefaultResCombiner{}, forward_m(args)...);
+	}
+	/*
+		\brief	当前嵌套的emit(包括collect及其各种变体)的层数,在槽中可用来判断是否处于重入之中
+	*/
+	std::size_t emission_depth()const noexcept {
+		return emit_depth_;
+	}
+
 	/*
 		\brief	直接调用所有事件
 		\note	受到perfect forward的影响,限制了某些推导,
@@ -343,11 +738,37 @@ public:
 	/*
 		\brief	在某些情况下无法forward,所以提供该函数来方便其emit
 		\param	参数类型Ps...
-		\note	如果是引用的话,并不会有复制开销,但如果是值类型则会
-				有多余的复制产生,因为std::function也像这样复制了参数.
+		\note	值类型的参数以const&传递给除最后一个可调用的槽之外的所有槽,
+				最后一个槽则得到参数的右值,因此对于只有一个槽的信号不会产生额外的复制.
+				槽的形参为值类型时,std::function在每个槽处仍会复制一次(最后一个槽为移动).
+				在emit期间新连接的槽不会被调用,因此"最后一个"是emit开始时的最后一个槽,
+				若轮到它时它不可调用(被阻塞或断开),则所有的槽都以const&接收参数.
 	*/
 	void emit(Ps...args) {
-		visit(DefaultResCombiner{}, forward_m(args)...);
+		using Iter = const_iterator;
+		using Cache = CacheRes<R>;
+		ScopedMark<std::size_t> depth(emit_depth_);
+		//emit期间新连接的槽不会被调用,因此开始时的最后一个节点就是最后一个可能被调用的槽
+		Iter last = slot_list.cbefore_end();
+		auto getter = [&args..., &last](Cache& cache, const Iter& iter)->typename Cache::reference_type
+		{
+			if (!cache) {
+				if (iter == last) {
+					cache.reset(iter, std::forward<Ps>(args)...);
+				} else {
+					cache.reset(iter, static_cast<SharedArgT<Ps>>(args)...);
+				}
+			}
+			return cache.get();
+		};
+		Cache cache{};
+		optional<ExpiredPurger> purger;
+		auto walk = makeWalk(slot_list.cbefore_begin(), last, getter, cache, purger);
+		DefaultResCombiner{}(
+			std::move(walk.first),
+			std::move(walk.second),
+			*this
+		);
 	}
 	template<class F>
 	void disconnect_one(F&& func) {
@@ -355,7 +776,7 @@ public:
 		auto prev = slot_list.before_begin();
 		auto end=slot_list.end();
 		while (iter != end) {
-			if (*iter==forward_m(func)) {
+			if (!iter->busy && *iter==forward_m(func)) {
 				iter=slot_list.erase_after(prev);
 				if (iter != end && iter->state != nullptr) {
 					iter->state->prev_node_ = prev;
@@ -375,7 +796,7 @@ public:
 		auto prev = slot_list.before_begin();
 		auto end=slot_list.end();
 		while (iter != end) {
-			if (*iter==forward_m(func)) {
+			if (!iter->busy && *iter==forward_m(func)) {
 				iter=slot_list.erase_after(prev);
 				if (iter == end)
 					break;
@@ -395,6 +816,20 @@ public:
 	bool empty()const noexcept {
 		return slot_list.empty();
 	}
+	/*
+		\brief	立即断开所有目标已经析构的槽,通常不需要显式调用,因为最外层的emit遍历时会自动进行
+		\return	断开的槽数
+		\note	不可在emit期间调用
+	*/
+	std::size_t purge_expired() {
+		return purgeExpired(HasExpired<typename SlotType::Base>{});
+	}
+	/*
+		\brief	按调用顺序只读地访问所有的槽(包括被阻塞的),用于检查槽的函数对象
+	*/
+	const container& slots()const noexcept {
+		return slot_list;
+	}
 
 	template<class Sig,class GetParram,class Cache,class Iterator>
 	friend CheckCallIterator<GetParram, Cache, Iterator> 
@@ -443,6 +878,25 @@ public://method
 template<class...Ts>
 using SimpleSignal = SignalWrapper<BasicSignal, Ts...>;
 
+/*
+	\brief	槽保存在ChunkList中,connect时一般不需要再为链表节点分配内存,
+			并且遍历时节点基本连续.
+*/
+template<class Functor>
+using PooledSlotTraits = DefaultSlotTraits<Functor, ChunkList>;
+
+template<class Signature>
+using PooledSignal = SimpleSignal<Signature, PooledSlotTraits<EqualableFunction<Signature>>>;
+
+/*
+	\brief	以SmallFunction作为槽的函数对象,不超过Capacity字节的函数对象在connect时无需额外分配.
+*/
+template<class Signature,std::size_t Capacity = 48>
+using SmallSlotTraits = DefaultSlotTraits<SmallFunction<Signature, Capacity>>;
+
+template<class Signature,std::size_t Capacity = 48>
+using SmallSignal = SimpleSignal<Signature, SmallSlotTraits<Signature, Capacity>>;
+
 template<class Sig,class GetParram,class Cache,class Iterator>
 CheckCallIterator<GetParram, Cache, Iterator>  
 makeLockedIter(const SlotCallIterator<GetParram,Cache,Iterator>& iter,Sig& c) {
@@ -0,0 +1,386 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "has_member.h"
+#include "basic_macro_impl.h"
+
+namespace Talg{
+
+/*
+	\brief	带内联缓冲区的类型擦除函数对象,可以直接作为DefaultSlotTraits的Functor.
+			不超过Capacity字节且可以无异常移动的函数对象直接构造在缓冲区中,否则才在堆上分配.
+			调用函数指针直接保存在对象内,调用只需一次间接跳转;
+			复制/移动/析构/相等比较放在每个类型唯一的静态表中,以表的地址识别类型,不依赖RTTI.
+	\param	Signature 形如R(Ps...),Capacity 内联缓冲区的字节数
+	\note	与std::function一样,operator()是const的,但调用的是目标的非const版本.
+			调用空对象会抛出std::bad_function_call.
+*/
+template<class Signature,std::size_t Capacity = 48>
+class SmallFunction;
+
+template<class R,class...Ps,std::size_t Capacity>
+class SmallFunction<R(Ps...),Capacity> {
+public:
+	using Signature = R(Ps...);
+	static constexpr std::size_t capacity = Capacity;
+	template<class T>
+	using rebind = SmallFunction<T, Capacity>;
+private:
+	using Storage = typename std::aligned_storage<
+		(Capacity < sizeof(void*) ? sizeof(void*) : Capacity),
+		alignof(std::max_align_t)
+	>::type;
+	using Invoker = R(*)(const Storage&, Ps&&...);
+	struct VTable {
+		void (*copy)(const Storage& src, Storage& dst);
+		void (*move)(Storage& src, Storage& dst);	//移动到dst之后销毁src中的对象
+		void (*destroy)(Storage& src);
+		void* (*target)(const Storage& src);
+		bool (*equal)(const void* lhs, const void* rhs);	//参数为两个目标对象
+		const VTable* type;		//标识目标对象的类型,为Manager<F>::table,与分配方式无关
+		bool is_inline;
+	};
+
+	template<class F>
+	struct FitsInline :std::integral_constant<bool,
+		sizeof(F) <= sizeof(Storage) &&
+		alignof(Storage) % alignof(F) == 0 &&
+		std::is_nothrow_move_constructible<F>::value
+	> {};
+
+	template<class F>
+	static bool equalImp(const F& lhs, const F& rhs, std::true_type) {
+		return lhs == rhs;
+	}
+	template<class F>
+	static bool equalImp(const F&, const F&, std::false_type)noexcept {
+		return false;
+	}
+	template<class F>
+	static bool equalTo(const F& lhs, const F& rhs) {
+		return equalImp(lhs, rhs, std::integral_constant<bool, hasEqualCompare<const F&>::value>{});
+	}
+
+	template<class F, bool = FitsInline<F>::value>
+	struct Manager {
+		static F* get(const Storage& src)noexcept {
+			return const_cast<F*>(reinterpret_cast<const F*>(&src));
+		}
+		template<class T>
+		static void create(Storage& dst, T&& func) {
+			::new (static_cast<void*>(&dst)) F(forward_m(func));
+		}
+		static void copy(const Storage& src, Storage& dst) {
+			create(dst, *get(src));
+		}
+		static void move(Storage& src, Storage& dst) {
+			create(dst, std::move(*get(src)));
+			get(src)->~F();
+		}
+		static void destroy(Storage& src) {
+			get(src)->~F();
+		}
+		static const VTable table;
+	};
+	template<class F>
+	struct Manager<F, false> {
+		static F* get(const Storage& src)noexcept {
+			return *reinterpret_cast<F* const*>(&src);
+		}
+		template<class T>
+		static void create(Storage& dst, T&& func) {
+			::new (static_cast<void*>(&dst)) F*(new F(forward_m(func)));
+		}
+		static void copy(const Storage& src, Storage& dst) {
+			create(dst, *get(src));
+		}
+		static void move(Storage& src, Storage& dst) {
+			::new (static_cast<void*>(&dst)) F*(get(src));
+		}
+		static void destroy(Storage& src) {
+			delete get(src);
+		}
+		static const VTable table;
+	};
+	//以allocator_arg构造且放不进缓冲区的目标对象与分配器一起保存,
+	//分配器为空类时不占空间(EBO),复制时使用同一个分配器
+	template<class F,class Alloc>
+	struct AllocManager {
+		struct Box;
+		using BoxAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Box>;
+		using Traits = std::allocator_traits<BoxAlloc>;
+		struct Box :BoxAlloc {
+			F func;
+			template<class T>
+			Box(const BoxAlloc& a, T&& f)
+				:BoxAlloc(a), func(forward_m(f))
+			{
+
+			}
+		};
+		static Box* box(const Storage& src)noexcept {
+			return *reinterpret_cast<Box* const*>(&src);
+		}
+		static F* get(const Storage& src)noexcept {
+			return &box(src)->func;
+		}
+		template<class T>
+		static void create(Storage& dst, const BoxAlloc& alloc, T&& func) {
+			BoxAlloc box_alloc(alloc);
+			auto ptr = Traits::allocate(box_alloc, 1);
+			try {
+				Traits::construct(box_alloc, std::addressof(*ptr), box_alloc, forward_m(func));
+			}
+			catch (...) {
+				Traits::deallocate(box_alloc, ptr, 1);
+				throw;
+			}
+			::new (static_cast<void*>(&dst)) Box*(std::addressof(*ptr));
+		}
+		static void copy(const Storage& src, Storage& dst) {
+			create(dst, *box(src), box(src)->func);
+		}
+		static void move(Storage& src, Storage& dst) {
+			::new (static_cast<void*>(&dst)) Box*(box(src));
+		}
+		static void destroy(Storage& src) {
+			auto self = box(src);
+			BoxAlloc box_alloc(*self);
+			Traits::destroy(box_alloc, self);
+			Traits::deallocate(box_alloc, self, 1);
+		}
+		static const VTable table;
+	};
+	template<class Alloc>
+	struct IsStdAlloc :std::false_type {};
+	template<class T>
+	struct IsStdAlloc<std::allocator<T>> :std::true_type {};
+
+	//能放进缓冲区或者分配器就是std::allocator时与普通的构造相同
+	template<class D,class Alloc,class F>
+	void createWith(const Alloc&, F&& func, std::true_type) {
+		Manager<D>::create(buf_, forward_m(func));
+		invoke_ = &invoke<Manager<D>>;
+		table_ = &Manager<D>::table;
+	}
+	template<class D,class Alloc,class F>
+	void createWith(const Alloc& alloc, F&& func, std::false_type) {
+		using M = AllocManager<D, Alloc>;
+		M::create(buf_, typename M::BoxAlloc(alloc), forward_m(func));
+		invoke_ = &invoke<M>;
+		table_ = &M::table;
+	}
+	template<class M>
+	static R invoke(const Storage& src, Ps&&...args) {
+		return (*M::get(src))(std::forward<Ps>(args)...);
+	}
+	template<class M>
+	static void* targetOf(const Storage& src)noexcept {
+		return M::get(src);
+	}
+	template<class F>
+	static bool equal(const void* lhs, const void* rhs) {
+		return equalTo(*static_cast<const F*>(lhs), *static_cast<const F*>(rhs));
+	}
+	static R emptyInvoke(const Storage&, Ps&&...) {
+		throw std::bad_function_call();
+	}
+
+	template<class F>
+	static bool isNull(const F&, std::false_type)noexcept {
+		return false;
+	}
+	template<class F>
+	static bool isNull(const F& func, std::true_type)noexcept {
+		return func == nullptr;
+	}
+	template<class F>
+	static bool isNull(const F& func)noexcept {
+		return isNull(func, std::integral_constant<bool,
+			std::is_pointer<F>::value || std::is_member_pointer<F>::value>{});
+	}
+
+	Invoker invoke_ = &emptyInvoke;
+	const VTable* table_ = nullptr;
+	Storage buf_{};
+
+	void reset()noexcept {
+		if (table_ != nullptr) {
+			table_->destroy(buf_);
+			table_ = nullptr;
+			invoke_ = &emptyInvoke;
+		}
+	}
+	void moveFrom(SmallFunction& rhs)noexcept {
+		if (rhs.table_ != nullptr) {
+			rhs.table_->move(rhs.buf_, buf_);
+			invoke_ = rhs.invoke_;
+			table_ = rhs.table_;
+			rhs.invoke_ = &emptyInvoke;
+			rhs.table_ = nullptr;
+		}
+	}
+public:
+	SmallFunction()noexcept {}
+	SmallFunction(std::nullptr_t)noexcept {}
+
+	template<class F,
+		class D = std::decay_t<F>,
+		class = std::enable_if_t<!std::is_base_of<SmallFunction, D>::value>,
+		class = decltype(std::declval<D&>()(std::declval<Ps>()...))
+	>
+	SmallFunction(F&& func) {
+		if (isNull(func)) {
+			return;
+		}
+		Manager<D>::create(buf_, forward_m(func));
+		invoke_ = &invoke<Manager<D>>;
+		table_ = &Manager<D>::table;
+	}
+	/*
+		\brief	放不进内联缓冲区的目标对象以alloc分配(复制时也使用同一个分配器),
+				从而可以让槽的函数对象与槽的其他部分一样来自同一个内存池.
+	*/
+	template<class Alloc,class F,
+		class D = std::decay_t<F>,
+		class = std::enable_if_t<!std::is_base_of<SmallFunction, D>::value>,
+		class = decltype(std::declval<D&>()(std::declval<Ps>()...))
+	>
+	SmallFunction(std::allocator_arg_t, const Alloc& alloc, F&& func) {
+		if (isNull(func)) {
+			return;
+		}
+		createWith<D>(alloc, forward_m(func), std::integral_constant<bool,
+			FitsInline<D>::value || IsStdAlloc<Alloc>::value>{});
+	}
+	SmallFunction(const SmallFunction& rhs)
+		:invoke_(rhs.invoke_), table_(rhs.table_)
+	{
+		if (table_ != nullptr) {
+			table_->copy(rhs.buf_, buf_);
+		}
+	}
+	SmallFunction(SmallFunction&& rhs)noexcept {
+		moveFrom(rhs);
+	}
+	SmallFunction& operator=(const SmallFunction& rhs) {
+		if (this != &rhs) {
+			SmallFunction tmp(rhs);
+			*this = std::move(tmp);
+		}
+		return *this;
+	}
+	SmallFunction& operator=(SmallFunction&& rhs)noexcept {
+		if (this != &rhs) {
+			reset();
+			moveFrom(rhs);
+		}
+		return *this;
+	}
+	SmallFunction& operator=(std::nullptr_t)noexcept {
+		reset();
+		return *this;
+	}
+	~SmallFunction() {
+		reset();
+	}
+
+	R operator()(Ps...args)const {
+		return invoke_(buf_, std::forward<Ps>(args)...);
+	}
+	explicit operator bool()const noexcept {
+		return table_ != nullptr;
+	}
+
+	/*
+		\brief	目标对象是否保存在内联缓冲区中,空对象返回true
+	*/
+	bool is_inline()const noexcept {
+		return table_ == nullptr || table_->is_inline;
+	}
+
+	/*
+		\brief	类型为F时返回目标对象的指针,否则返回nullptr
+	*/
+	template<class F>
+	F* target()noexcept {
+		return table_ != nullptr && table_->type == &Manager<F>::table ?
+			static_cast<F*>(table_->target(buf_)) : nullptr;
+	}
+	template<class F>
+	const F* target()const noexcept {
+		return table_ != nullptr && table_->type == &Manager<F>::table ?
+			static_cast<const F*>(table_->target(buf_)) : nullptr;
+	}
+
+	/*
+		\brief	两者保存的目标类型相同并且目标可以以==比较且相等时才相等,
+				这与EqualableFunction的语义一致.
+	*/
+	bool operator==(const SmallFunction& rhs)const {
+		if (table_ == nullptr || rhs.table_ == nullptr) {
+			return table_ == rhs.table_;
+		}
+		return table_->type == rhs.table_->type
+			&& table_->equal(table_->target(buf_), rhs.table_->target(rhs.buf_));
+	}
+	template<class F,
+		class = std::enable_if_t<!std::is_base_of<SmallFunction, F>::value>>
+	bool operator==(const F& rhs)const {
+		if (auto ptr = target<F>()) {
+			return equalTo(*ptr, rhs);
+		}
+		return false;
+	}
+	template<class F>
+	bool operator!=(const F& rhs)const {
+		return !(*this == rhs);
+	}
+};
+
+template<class R,class...Ps,std::size_t Capacity>
+template<class F,bool is_inline>
+const typename SmallFunction<R(Ps...),Capacity>::VTable
+SmallFunction<R(Ps...),Capacity>::Manager<F,is_inline>::table = {
+	&Manager::copy,
+	&Manager::move,
+	&Manager::destroy,
+	&SmallFunction::template targetOf<Manager>,
+	&SmallFunction::template equal<F>,
+	&Manager::table,
+	true
+};
+
+template<class R,class...Ps,std::size_t Capacity>
+template<class F>
+const typename SmallFunction<R(Ps...),Capacity>::VTable
+SmallFunction<R(Ps...),Capacity>::Manager<F,false>::table = {
+	&Manager::copy,
+	&Manager::move,
+	&Manager::destroy,
+	&SmallFunction::template targetOf<Manager>,
+	&SmallFunction::template equal<F>,
+	&Manager::table,
+	false
+};
+
+template<class R,class...Ps,std::size_t Capacity>
+template<class F,class Alloc>
+const typename SmallFunction<R(Ps...),Capacity>::VTable
+SmallFunction<R(Ps...),Capacity>::AllocManager<F,Alloc>::table = {
+	&AllocManager::copy,
+	&AllocManager::move,
+	&AllocManager::destroy,
+	&SmallFunction::template targetOf<AllocManager>,
+	&SmallFunction::template equal<F>,
+	&Manager<F>::table,
+	false
+};
+
+}//namespace Talg
+
+#include "undef_macro.h"
@@ -0,0 +1,209 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "function_wrapper.h"
+#include "slot_iterator.h"
+#include "signal_wrapper.h"
+#include "basic_macro_impl.h"
+
+namespace Talg {
+
+/*
+	\brief	StaticSignal中的一个槽,函数对象以FunctorImp适配到信号的签名,
+			因此与makeFunctor一样,槽可以只接受信号参数中的一部分.
+*/
+template<class Functor>
+struct StaticSlot {
+	Functor func;
+	bool blocked = false;
+
+	template<class...Ts>
+	explicit constexpr StaticSlot(Ts&&...args)
+		:func(forward_m(args)...)
+	{
+
+	}
+	bool is_callable()const noexcept {
+		return !blocked;
+	}
+	void block()noexcept {
+		blocked = true;
+	}
+	void unblock()noexcept {
+		blocked = false;
+	}
+};
+
+/*
+	\brief	槽的集合在编译期确定的信号,槽直接保存在tuple中.
+			operator()展开成对每个槽的直接调用,没有类型擦除也没有链表遍历,编译器可以将其全部内联.
+	\param	Signature 信号的签名,Fs 各个槽的函数对象类型(按调用顺序)
+	\note	collect仍然遵循BasicSignal的ResCombiner协议,此时经由一张函数指针表调用各个槽,
+			因此同一个组合器可以同时用于两种信号.
+			参数以左值的形式传递给每一个槽.
+			槽不能增删,只能以block<I>()/unblock<I>()临时屏蔽.
+*/
+template<class Signature,class...Fs>
+class StaticSignal;
+
+template<class R,class...Ps,class...Fs>
+class StaticSignal<R(Ps...),Fs...> {
+public:
+	using Signature = R(Ps...);
+	template<std::size_t I>
+	using SlotType = StaticSlot<FunctorImp<std::tuple_element_t<I, std::tuple<Fs...>>, Signature>>;
+	static constexpr std::size_t size_v = sizeof...(Fs);
+private:
+	using Slots = std::tuple<StaticSlot<FunctorImp<Fs, Signature>>...>;
+	Slots slots_;
+
+	//collect时充当槽的视图,以函数指针表的形式调用tuple中的第I个槽
+	struct SlotRef {
+		using Thunk = R(*)(void*, Ps...);
+		void* slot;
+		Thunk thunk;
+		bool callable;
+
+		bool is_callable()const noexcept {
+			return callable;
+		}
+		template<class...Ts>
+		R operator()(Ts&&...args)const {
+			return thunk(slot, forward_m(args)...);
+		}
+	};
+	template<std::size_t I>
+	static R invokeSlot(void* slot, Ps...args) {
+		return static_cast<SlotType<I>*>(slot)->func(forward_m(args)...);
+	}
+	template<std::size_t...Is>
+	std::array<SlotRef, size_v> makeTable(std::index_sequence<Is...>) {
+		return {{ SlotRef{ &std::get<Is>(slots_), &invokeSlot<Is>,
+			std::get<Is>(slots_).is_callable() }... }};
+	}
+
+	template<class Slot,class...Ts>
+	static void callSlot(Slot& slot, Ts&...args) {
+		if (slot.is_callable()) {
+			slot.func(args...);
+		}
+	}
+	template<std::size_t...Is,class...Ts>
+	void callAll(std::index_sequence<Is...>, Ts&...args) {
+		using expand = int[];
+		(void)expand{ 0, (callSlot(std::get<Is>(slots_), args...), 0)... };
+	}
+	template<std::size_t I>
+	void emitSlot(std::size_t last, Ps&...args) {
+		auto& slot = std::get<I>(slots_);
+		if (!slot.is_callable()) {
+			return;
+		}
+		if (I == last) {
+			slot.func(std::forward<Ps>(args)...);
+		} else {
+			slot.func(static_cast<SharedArgT<Ps>>(args)...);
+		}
+	}
+	template<std::size_t...Is>
+	void emitAll(std::index_sequence<Is...>, Ps&...args) {
+		std::size_t last = size_v;
+		using expand = int[];
+		(void)expand{ 0, (std::get<Is>(slots_).is_callable() ? (last = Is, 0) : 0)... };
+		(void)expand{ 0, (emitSlot<Is>(last, args...), 0)... };
+	}
+public:
+	constexpr StaticSignal() = default;
+	template<class...Ts,
+			 class = std::enable_if_t<sizeof...(Ts) == sizeof...(Fs) && (sizeof...(Ts) != 0)>>
+	explicit constexpr StaticSignal(Ts&&...funcs)
+		:slots_(StaticSlot<FunctorImp<Fs, Signature>>(forward_m(funcs))...)
+	{
+
+	}
+
+	/*
+		\brief	依次直接调用所有未被屏蔽的槽并丢弃结果
+	*/
+	template<class...Ts>
+	void operator()(Ts&&...args) {
+		callAll(std::index_sequence_for<Fs...>{}, args...);
+	}
+	/*
+		\brief	同BasicSignal::emit,最后一个可调用的槽得到参数的右值,其余的槽以const&接收.
+				槽直接以FunctorImp调用,因此槽不使用的参数不会被复制.
+	*/
+	void emit(Ps...args) {
+		emitAll(std::index_sequence_for<Fs...>{}, args...);
+	}
+
+	/*
+		\brief	以结果组合器调用所有的槽,组合器协议与BasicSignal::collect相同
+	*/
+	template<class ResCombiner,class...Ts>
+	decltype(auto) collect(ResCombiner&& res_collector, Ts&&...args) {
+		auto table = makeTable(std::index_sequence_for<Fs...>{});
+		auto range = makeIndexSlotRange(table);
+		using Iter = decltype(range.first);
+		using Cache = CacheRes<R>;
+		auto getter = [&args...](Cache& cache, const Iter& iter)->typename Cache::reference_type
+		{
+			if (!cache) {
+				cache.reset(iter, args...);
+			}
+			return cache.get();
+		};
+		Cache cache{};
+		return forward_m(res_collector)(
+			makeSlotIter<R>(range.first, getter, cache),
+			makeSlotIter<R>(range.second, getter, cache),
+			*this
+		);
+	}
+
+	template<std::size_t I>
+	SlotType<I>& slot()noexcept {
+		return std::get<I>(slots_);
+	}
+	template<std::size_t I>
+	const SlotType<I>& slot()const noexcept {
+		return std::get<I>(slots_);
+	}
+	template<std::size_t I>
+	void block()noexcept {
+		slot<I>().block();
+	}
+	template<std::size_t I>
+	void unblock()noexcept {
+		slot<I>().unblock();
+	}
+	template<std::size_t I>
+	bool is_blocked()const noexcept {
+		return !slot<I>().is_callable();
+	}
+	static constexpr std::size_t size()noexcept {
+		return size_v;
+	}
+	static constexpr bool empty()noexcept {
+		return size_v == 0;
+	}
+};
+
+template<class R,class...Ps,class...Fs>
+constexpr std::size_t StaticSignal<R(Ps...), Fs...>::size_v;
+
+/*
+	\brief	由各个槽推导出StaticSignal的类型
+	\param	Signature 信号的签名,funcs 各个槽,以值保存
+*/
+template<class Signature,class...Fs>
+constexpr StaticSignal<Signature, std::decay_t<Fs>...> makeStaticSignal(Fs&&...funcs) {
+	return StaticSignal<Signature, std::decay_t<Fs>...>(forward_m(funcs)...);
+}
+
+}//namespace Talg
+
+#include "undef_macro.h"
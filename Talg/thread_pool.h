@@ -0,0 +1,166 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <cstddef>
+#include "basic_macro_impl.h"
+
+namespace Talg{
+
+/*
+	\brief	执行器的要求(供BasicSignal::collect_parallel等使用):
+			concurrency() 返回除调用者之外可以同时工作的线程数;
+			bulk_execute(n,f) 以[0,n)中的每个下标调用一次f,全部完成之后才返回,
+			若有f抛出异常则在返回时重新抛出其中一个.
+*/
+
+/*
+	\brief	在调用者线程中依次执行所有任务的执行器
+*/
+struct InlineExecutor {
+	std::size_t concurrency()const noexcept {
+		return 0;
+	}
+	template<class F>
+	void bulk_execute(std::size_t n, F&& func) {
+		for (std::size_t i = 0; i != n; ++i) {
+			func(i);
+		}
+	}
+};
+
+/*
+	\brief	固定线程数的线程池.
+	\note	bulk_execute时调用者线程也参与执行,下标由原子计数器动态分配,
+			因此各个任务的耗时不均时也能保持负载均衡.
+*/
+class ThreadPool {
+	std::mutex mtx_;
+	std::condition_variable cv_;
+	std::deque<std::function<void()>> tasks_;
+	std::vector<std::thread> workers_;
+	bool stop_ = false;
+
+	void run() {
+		for (;;) {
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(mtx_);
+				cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+				if (tasks_.empty()) {
+					return;
+				}
+				task = std::move(tasks_.front());
+				tasks_.pop_front();
+			}
+			task();
+		}
+	}
+public:
+	explicit ThreadPool(std::size_t thread_count = std::thread::hardware_concurrency()) {
+		workers_.reserve(thread_count);
+		for (std::size_t i = 0; i != thread_count; ++i) {
+			workers_.emplace_back([this] { run(); });
+		}
+	}
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+	~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock(mtx_);
+			stop_ = true;
+		}
+		cv_.notify_all();
+		for (auto& th : workers_) {
+			th.join();
+		}
+	}
+
+	std::size_t concurrency()const noexcept {
+		return workers_.size();
+	}
+
+	/*
+		\brief	异步执行task,不等待其完成
+	*/
+	template<class F>
+	void execute(F&& task) {
+		{
+			std::lock_guard<std::mutex> lock(mtx_);
+			tasks_.emplace_back(forward_m(task));
+		}
+		cv_.notify_one();
+	}
+
+	/*
+		\brief	以[0,n)中的每个下标调用func,调用者线程也参与执行,全部完成之后才返回
+		\note	可以在池中的线程里嵌套调用:调用者只等待已经开始执行的辅助任务,
+				尚在队列中的辅助任务在调用者处理完所有下标之后直接返回,不再访问func.
+	*/
+	template<class F>
+	void bulk_execute(std::size_t n, F&& func) {
+		if (n == 0) {
+			return;
+		}
+		//辅助任务可能在bulk_execute返回之后才被取出,所以共享状态不能放在栈上
+		struct Shared {
+			std::atomic<std::size_t> next{0};
+			std::mutex mtx;
+			std::condition_variable cv;
+			std::size_t running = 0;
+			bool closed = false;
+			std::exception_ptr error;
+		};
+		using Func = std::remove_reference_t<F>;
+		auto shared = std::make_shared<Shared>();
+		auto work = [](Shared& sh, Func& f, std::size_t count) {
+			for (std::size_t i = sh.next++; i < count; i = sh.next++) {
+				try {
+					f(i);
+				}
+				catch (...) {
+					std::lock_guard<std::mutex> lock(sh.mtx);
+					if (!sh.error) {
+						sh.error = std::current_exception();
+					}
+				}
+			}
+		};
+		Func* pf = std::addressof(func);
+		std::size_t helpers = n - 1 < workers_.size() ? n - 1 : workers_.size();
+		for (std::size_t i = 0; i != helpers; ++i) {
+			execute([shared, pf, n, work] {
+				{
+					std::lock_guard<std::mutex> lock(shared->mtx);
+					if (shared->closed) {
+						return;
+					}
+					++shared->running;
+				}
+				work(*shared, *pf, n);
+				std::lock_guard<std::mutex> lock(shared->mtx);
+				if (--shared->running == 0) {
+					shared->cv.notify_one();
+				}
+			});
+		}
+		work(*shared, func, n);
+		std::unique_lock<std::mutex> lock(shared->mtx);
+		shared->closed = true;
+		shared->cv.wait(lock, [&shared] { return shared->running == 0; });
+		if (shared->error) {
+			std::rethrow_exception(shared->error);
+		}
+	}
+};
+
+}//namespace Talg
+
+#include "undef_macro.h"
@@ -0,0 +1,427 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "chrono_io.h"
+#include "small_function.h"
+#include "basic_macro_impl.h"
+
+namespace Talg {
+
+/*
+	\brief	定时器的句柄,定时器触发或取消之后失效(gen不再相同)
+*/
+struct TimerId {
+	std::uint32_t index = 0;
+	std::uint32_t gen = 0;		//0永远无效,因此默认构造的TimerId不对应任何定时器
+
+	friend bool operator==(const TimerId& lhs, const TimerId& rhs)noexcept {
+		return lhs.index == rhs.index && lhs.gen == rhs.gen;
+	}
+	friend bool operator!=(const TimerId& lhs, const TimerId& rhs)noexcept {
+		return !(lhs == rhs);
+	}
+};
+
+/*
+	\brief	定时器到期时以保存的参数调用信号
+	\note	只保存信号的地址,信号必须活得比定时器更久(或者在析构前cancel)
+*/
+template<class Signal,class...Ts>
+struct SignalTimerTask {
+	Signal* sig;
+	std::tuple<Ts...> args;
+
+	template<std::size_t...Is>
+	void fire(std::index_sequence<Is...>) {
+		(*sig)(std::get<Is>(args)...);
+	}
+	void operator()() {
+		fire(std::index_sequence_for<Ts...>{});
+	}
+};
+
+/*
+	\brief	分层的时间轮.每层64个槽,第L层的一个槽跨64^L个tick,共levels层.
+			定时器按到期的tick与当前tick的最高不同位决定放在哪一层,
+			每当当前tick进入第L层的一个新槽时,把该槽中的定时器重新放到更低的层中,
+			最终在第0层到期的那个tick触发.
+			schedule与cancel都是O(1):定时器是节点池中以下标链接的双向链表节点,
+			cancel只需从链表中摘下并放回空闲链表,适合绝大多数定时器在到期前就被取消的场合.
+	\param	Clock 驱动时间轮的时钟,Duration 表示tick的时长的类型,
+			Callback 定时器的回调,以void()调用
+	\note	时间轮只在advance/poll时前进,定时器不会早于指定的时间触发,
+			但可能晚至多一个tick(以及两次poll之间的间隔).
+			相对时间(schedule_after)以时间轮的当前时间now()为起点,而不是Clock::now().
+			回调中可以schedule或cancel,此时新的定时器最早在下一个tick触发.
+			回调抛出的异常从advance传出,同一tick中尚未触发的定时器在下一次advance时触发.
+			不是线程安全的,也不能在回调中再次调用advance.
+*/
+template<class Clock = std::chrono::steady_clock,
+		 class Duration = std::chrono::milliseconds,
+		 class Callback = SmallFunction<void(), 32>
+>
+class BasicTimingWheel {
+public:
+	using clock = Clock;
+	using duration = Duration;
+	using time_point = typename Clock::time_point;
+	using callback_type = Callback;
+
+	static constexpr std::size_t levels = 6;
+	static constexpr std::size_t slot_bits = 6;
+	static constexpr std::size_t slots = std::size_t(1) << slot_bits;
+private:
+	static constexpr std::uint64_t slot_mask = slots - 1;
+	static constexpr std::uint32_t nil = ~std::uint32_t(0);
+	static constexpr std::uint8_t free_level = 0xFF;
+
+	struct Node {
+		std::uint64_t deadline;		//到期的tick
+		std::uint32_t prev;
+		std::uint32_t next;			//空闲时用作空闲链表的链接
+		std::uint32_t gen;
+		std::uint8_t level;			//空闲时为free_level
+		std::uint8_t slot;
+	};
+
+	std::vector<Node> nodes_;
+	std::vector<Callback> callbacks_;		//与nodes_一一对应,使节点本身保持紧凑
+	std::uint32_t free_ = nil;
+	std::uint32_t heads_[levels][slots];
+	std::uint64_t occupied_[levels] = {};	//每层中非空的槽
+	std::uint64_t cur_ = 0;					//已经处理过的最后一个tick
+	std::size_t count_ = 0;
+	Duration tick_;
+	typename Clock::duration tick_clock_;
+	time_point origin_;
+
+	static std::size_t lowestBit(std::uint64_t x)noexcept {
+		//de Bruijn序列,x不能为0
+		static constexpr std::uint8_t table[64] = {
+			0, 1, 2, 53, 3, 7, 54, 27, 4, 38, 41, 8, 34, 55, 48, 28,
+			62, 5, 39, 46, 44, 42, 22, 9, 24, 35, 59, 56, 49, 18, 29, 11,
+			63, 52, 6, 26, 37, 40, 33, 47, 61, 45, 43, 21, 23, 58, 17, 10,
+			51, 25, 36, 32, 60, 20, 57, 16, 50, 31, 19, 15, 30, 14, 13, 12
+		};
+		return table[((x & (~x + 1)) * 0x022fdd63cc95386dull) >> 58];
+	}
+	static std::uint64_t shiftOf(std::size_t level)noexcept {
+		return static_cast<std::uint64_t>(level * slot_bits);
+	}
+
+	std::uint64_t ticksOf(time_point tp, bool round_up)const noexcept {
+		if (tp <= origin_) {
+			return 0;
+		}
+		auto d = static_cast<std::uint64_t>((tp - origin_).count());
+		auto t = static_cast<std::uint64_t>(tick_clock_.count());
+		return round_up ? d / t + (d % t != 0) : d / t;
+	}
+	time_point timeOf(std::uint64_t tick)const noexcept {
+		return origin_ + tick_clock_ * static_cast<typename Clock::duration::rep>(tick);
+	}
+
+	void link(std::uint32_t id) {
+		auto& node = nodes_[id];
+		std::uint64_t diff = node.deadline ^ cur_;
+		std::size_t level = 0;
+		while (level + 1 != levels && (diff >> shiftOf(level + 1)) != 0) {
+			++level;
+		}
+		auto slot = static_cast<std::size_t>((node.deadline >> shiftOf(level)) & slot_mask);
+		auto& head = heads_[level][slot];
+		node.level = static_cast<std::uint8_t>(level);
+		node.slot = static_cast<std::uint8_t>(slot);
+		node.prev = nil;
+		node.next = head;
+		if (head != nil) {
+			nodes_[head].prev = id;
+		}
+		head = id;
+		occupied_[level] |= std::uint64_t(1) << slot;
+	}
+	void unlink(std::uint32_t id)noexcept {
+		auto& node = nodes_[id];
+		if (node.prev != nil) {
+			nodes_[node.prev].next = node.next;
+		} else {
+			heads_[node.level][node.slot] = node.next;
+			if (node.next == nil) {
+				occupied_[node.level] &= ~(std::uint64_t(1) << node.slot);
+			}
+		}
+		if (node.next != nil) {
+			nodes_[node.next].prev = node.prev;
+		}
+	}
+	std::uint32_t allocNode() {
+		if (free_ != nil) {
+			auto id = free_;
+			free_ = nodes_[id].next;
+			return id;
+		}
+		if (nodes_.size() >= nil) {
+			throw std::length_error("too many timers.");
+		}
+		callbacks_.emplace_back();
+		nodes_.push_back(Node{ 0, nil, nil, 1, free_level, 0 });
+		return static_cast<std::uint32_t>(nodes_.size() - 1);
+	}
+	//回调应当已经移出
+	void freeNode(std::uint32_t id)noexcept {
+		auto& node = nodes_[id];
+		node.level = free_level;
+		if (++node.gen == 0) {
+			node.gen = 1;
+		}
+		node.next = free_;
+		free_ = id;
+		--count_;
+	}
+
+	//把第level层当前槽中的定时器放到更低的层中
+	void cascade(std::size_t level) {
+		auto slot = static_cast<std::size_t>((cur_ >> shiftOf(level)) & slot_mask);
+		auto id = heads_[level][slot];
+		heads_[level][slot] = nil;
+		occupied_[level] &= ~(std::uint64_t(1) << slot);
+		while (id != nil) {
+			auto next = nodes_[id].next;
+			link(id);
+			id = next;
+		}
+	}
+	std::size_t fireSlot(std::size_t slot) {
+		std::size_t fired = 0;
+		while (heads_[0][slot] != nil) {
+			auto id = heads_[0][slot];
+			unlink(id);
+			Callback func = std::move(callbacks_[id]);
+			callbacks_[id] = nullptr;
+			freeNode(id);
+			++fired;
+			func();
+		}
+		return fired;
+	}
+	/*
+		\return	下一个需要处理的tick(大于cur_),没有定时器时返回UINT64_MAX
+		\note	最高层可能含有超出其范围的定时器,因此只保守地返回它的下一个槽的起点.
+	*/
+	std::uint64_t nextTick()const noexcept {
+		std::uint64_t next = ~std::uint64_t(0);
+		for (std::size_t level = 0; level != levels; ++level) {
+			if (occupied_[level] == 0) {
+				continue;
+			}
+			auto shift = shiftOf(level);
+			std::uint64_t candidate;
+			if (level + 1 == levels) {
+				candidate = ((cur_ >> shift) + 1) << shift;
+			} else {
+				auto index = (cur_ >> shift) & slot_mask;
+				auto later = index == slot_mask ? 0 : occupied_[level] & (~std::uint64_t(0) << (index + 1));
+				if (later == 0) {
+					continue;
+				}
+				auto group = (cur_ >> (shift + slot_bits)) << (shift + slot_bits);
+				candidate = group | (static_cast<std::uint64_t>(lowestBit(later)) << shift);
+			}
+			if (candidate < next) {
+				next = candidate;
+			}
+		}
+		return next;
+	}
+
+	template<class F>
+	TimerId add(std::uint64_t deadline, F&& func) {
+		auto id = allocNode();
+		//回调的构造可能抛出异常,此时节点仍是空闲的
+		try {
+			callbacks_[id] = Callback(forward_m(func));
+		} catch (...) {
+			nodes_[id].next = free_;
+			free_ = id;
+			throw;
+		}
+		nodes_[id].deadline = deadline > cur_ ? deadline : cur_ + 1;
+		link(id);
+		++count_;
+		return TimerId{ id, nodes_[id].gen };
+	}
+public:
+	/*
+		\param	tick 每个tick的时长,origin 第0个tick的时间
+	*/
+	explicit BasicTimingWheel(Duration tick = Duration(1), time_point origin = Clock::now())
+		:tick_(tick),
+		tick_clock_(std::chrono::duration_cast<typename Clock::duration>(tick)),
+		origin_(origin)
+	{
+		if (tick_clock_.count() <= 0) {
+			throw std::invalid_argument("tick of the timing wheel must be positive.");
+		}
+		for (auto& level : heads_) {
+			for (auto& head : level) {
+				head = nil;
+			}
+		}
+	}
+	BasicTimingWheel(const BasicTimingWheel&) = delete;
+	BasicTimingWheel& operator=(const BasicTimingWheel&) = delete;
+
+	/*
+		\brief	在when(或之后的第一个tick)调用func
+	*/
+	template<class F>
+	TimerId schedule_at(time_point when, F&& func) {
+		return add(ticksOf(when, true), forward_m(func));
+	}
+	/*
+		\brief	在now()+delay之后调用func
+	*/
+	template<class Rep,class Period,class F>
+	TimerId schedule_after(std::chrono::duration<Rep, Period> delay, F&& func) {
+		return schedule_at(now() + std::chrono::duration_cast<typename Clock::duration>(delay), forward_m(func));
+	}
+	/*
+		\brief	到期时以args的副本调用sig(args...),sig可以是任何信号(如SimpleSignal)
+	*/
+	template<class Signal,class...Ts>
+	TimerId fire_at(time_point when, Signal& sig, Ts&&...args) {
+		return schedule_at(when, SignalTimerTask<Signal, std::decay_t<Ts>...>{ &sig, std::make_tuple(forward_m(args)...) });
+	}
+	template<class Rep,class Period,class Signal,class...Ts>
+	TimerId fire_after(std::chrono::duration<Rep, Period> delay, Signal& sig, Ts&&...args) {
+		return schedule_after(delay, SignalTimerTask<Signal, std::decay_t<Ts>...>{ &sig, std::make_tuple(forward_m(args)...) });
+	}
+
+	/*
+		\return	定时器是否仍未触发,已经触发或取消过的返回false
+	*/
+	bool cancel(TimerId timer) {
+		if (!pending(timer)) {
+			return false;
+		}
+		unlink(timer.index);
+		Callback func = std::move(callbacks_[timer.index]);
+		callbacks_[timer.index] = nullptr;
+		freeNode(timer.index);
+		return true;
+	}
+	bool pending(TimerId timer)const noexcept {
+		return timer.index < nodes_.size()
+			&& nodes_[timer.index].gen == timer.gen
+			&& nodes_[timer.index].level != free_level;
+	}
+	/*
+		\brief	取消所有的定时器
+	*/
+	void clear() {
+		for (std::uint32_t id = 0; id != nodes_.size(); ++id) {
+			if (nodes_[id].level != free_level) {
+				unlink(id);
+				callbacks_[id] = nullptr;
+				freeNode(id);
+			}
+		}
+	}
+
+	/*
+		\brief	前进到time之前的最后一个tick,依次触发到期的定时器
+		\return	触发的定时器个数
+		\note	没有定时器的tick整段跳过,代价与其间的定时器个数以及层数成正比,而不是tick数.
+	*/
+	std::size_t advance(time_point time) {
+		auto target = ticksOf(time, false);
+		std::size_t fired = 0;
+		if (occupied_[0] & (std::uint64_t(1) << (cur_ & slot_mask))) {
+			fired += fireSlot(static_cast<std::size_t>(cur_ & slot_mask));	//上一次advance因异常而未完成的
+		}
+		while (cur_ < target) {
+			auto next = nextTick();
+			if (next > target) {
+				cur_ = target;
+				break;
+			}
+			cur_ = next;
+			for (std::size_t level = levels - 1; level != 0; --level) {
+				if ((cur_ & ((std::uint64_t(1) << shiftOf(level)) - 1)) == 0) {
+					cascade(level);
+				}
+			}
+			fired += fireSlot(static_cast<std::size_t>(cur_ & slot_mask));
+		}
+		return fired;
+	}
+	/*
+		\brief	以Clock::now()前进
+	*/
+	std::size_t poll() {
+		return advance(Clock::now());
+	}
+
+	/*
+		\brief	时间轮的当前时间,即已经处理过的最后一个tick的时间
+	*/
+	time_point now()const noexcept {
+		return timeOf(cur_);
+	}
+	/*
+		\brief	下一次需要advance的时间,没有定时器时返回time_point::max().
+				可以用作事件循环的等待时限,这时可能提前醒来(只为了下移高层的定时器).
+	*/
+	time_point next_wakeup()const noexcept {
+		if (occupied_[0] & (std::uint64_t(1) << (cur_ & slot_mask))) {
+			return now();
+		}
+		auto next = nextTick();
+		return next == ~std::uint64_t(0) ? time_point::max() : timeOf(next);
+	}
+	Duration tick()const noexcept {
+		return tick_;
+	}
+	/*
+		\brief	从origin开始经过的tick数
+	*/
+	std::uint64_t ticks()const noexcept {
+		return cur_;
+	}
+	std::size_t size()const noexcept {
+		return count_;
+	}
+	bool empty()const noexcept {
+		return count_ == 0;
+	}
+	/*
+		\brief	预先分配n个定时器的空间
+	*/
+	void reserve(std::size_t n) {
+		nodes_.reserve(n);
+		callbacks_.reserve(n);
+	}
+};
+
+/*
+	\brief	以chrono_io的格式输出时间轮的摘要,如"timers=3 tick=1ms elapsed=120ms"
+*/
+template<class Out,class Clock,class Duration,class Callback>
+Out& operator<<(Out& out, const BasicTimingWheel<Clock, Duration, Callback>& wheel) {
+	out << "timers=" << wheel.size()
+		<< " tick=" << wheel.tick()
+		<< " elapsed=" << wheel.tick() * static_cast<typename Duration::rep>(wheel.ticks());
+	return out;
+}
+
+using TimingWheel = BasicTimingWheel<>;
+
+}//namespace Talg
+
+#include "undef_macro.h"
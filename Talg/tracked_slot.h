@@ -0,0 +1,79 @@
+#pragma once
+#include <memory>
+#include <type_traits>
+#include "slotlist.h"
+#include "basic_macro_impl.h"
+
+namespace Talg {
+
+template<class T>
+struct IsWeakMemFun :std::false_type {};
+template<class T,class MemPtr,class S>
+struct IsWeakMemFun<MemFun<std::weak_ptr<T>, MemPtr, S>> :std::true_type {};
+
+/*
+	\brief	跟踪目标对象的槽函数对象,用作DefaultSlotTraits的函数对象.
+			由MemFun<std::weak_ptr<T>>(即connect(shared_ptr,&T::f))构造时,
+			只保存weak_ptr用于检查存活,调用则直接经由对象指针进行,
+			因此调用时既不需要lock()产生的两次原子操作,也不会抛出bad_weak_ptr.
+			目标析构之后expired()为true,该槽不再被调用,并在最外层的emit遍历经过它时被断开.
+	\note	由其他函数对象构造时不跟踪任何对象,与Functor本身相同.
+			expired()只是读取引用计数,调用期间对象的存活由使用者保证:
+			对象不能在另一个线程中与emit同时析构.
+*/
+template<class Functor>
+class TrackedFunction :public Functor {
+	std::weak_ptr<const void> tracked_;
+	bool tracking_ = false;
+public:
+	using Base = Functor;
+	template<class T>
+	using rebind = TrackedFunction<RebindFunctor<Functor, T>>;
+
+	TrackedFunction() = default;
+	template<class F,
+			 class = std::enable_if_t<!std::is_base_of<TrackedFunction, std::decay_t<F>>::value
+								   && !IsWeakMemFun<std::decay_t<F>>::value>>
+	TrackedFunction(F&& func)
+		:Base(forward_m(func))
+	{
+
+	}
+	template<class T,class MemPtr,class S>
+	TrackedFunction(const MemFun<std::weak_ptr<T>, MemPtr, S>& func)
+		:Base(func.unchecked()), tracked_(func.tracked()), tracking_(true)
+	{
+
+	}
+
+	bool expired()const noexcept {
+		return tracking_ && tracked_.expired();
+	}
+
+	/*
+		\brief	与connect时的参数比较,MemFun<std::weak_ptr<T>>以其对象指针的版本比较
+	*/
+	template<class T,class MemPtr,class S>
+	bool operator==(const MemFun<std::weak_ptr<T>, MemPtr, S>& rhs)const {
+		return static_cast<const Base&>(*this) == rhs.unchecked();
+	}
+	template<class F,
+			 class = std::enable_if_t<!IsWeakMemFun<F>::value && !std::is_base_of<TrackedFunction, F>::value>>
+	bool operator==(const F& rhs)const {
+		return static_cast<const Base&>(*this) == rhs;
+	}
+	template<class F>
+	bool operator!=(const F& rhs)const {
+		return !(*this == rhs);
+	}
+};
+
+template<class Functor,template<class...>class Container = SingleList>
+using TrackedSlotTraits = DefaultSlotTraits<TrackedFunction<Functor>, Container>;
+
+template<class Signature>
+using TrackedSignal = SimpleSignal<Signature, TrackedSlotTraits<EqualableFunction<Signature>>>;
+
+}//namespace Talg
+
+#include "undef_macro.h"
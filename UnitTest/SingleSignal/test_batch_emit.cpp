@@ -0,0 +1,39 @@
+#include <doctest/doctest.h>
+#include <Talg/slotlist.h>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+using namespace Talg;
+
+TEST_CASE("Batch Emit") {
+	SimpleSignal<void(int, const std::string&)> sig;
+	std::vector<std::string> log;
+	sig += [&log](int v, const std::string& s) { log.push_back("a" + std::to_string(v) + s); };
+	sig += [&log](int v) { log.push_back("b" + std::to_string(v)); };
+	auto blocked = sig + [&log](int) { log.push_back("c"); };
+	blocked->block();
+
+	std::vector<std::tuple<int, std::string>> batch{ { 1,"x" },{ 2,"y" },{ 3,"z" } };
+	sig.emit_batch(batch);
+	CHECK(log == std::vector<std::string>{ "a1x", "a2y", "a3z", "b1", "b2", "b3" });
+}
+
+TEST_CASE("Batch Collect") {
+	SimpleSignal<int(int, int)> sig;
+	sig += [](int a, int b) { return a + b; };
+	sig += [](int a, int b) { return a * b; };
+	std::vector<std::pair<int, int>> batch{ { 1,2 },{ 3,4 } };
+	auto res = sig.collect_batch([](auto first, auto last, auto&) {
+		std::vector<std::vector<int>> per_slot;
+		for (; first != last; ++first) {
+			if (first) {
+				per_slot.push_back(*first);
+			}
+		}
+		return per_slot;
+	}, batch);
+	REQUIRE(res.size() == 2);
+	CHECK(res[0] == std::vector<int>{ 3, 7 });
+	CHECK(res[1] == std::vector<int>{ 2, 12 });
+}
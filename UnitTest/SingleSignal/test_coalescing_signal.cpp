@@ -0,0 +1,81 @@
+#include <doctest/doctest.h>
+#include <Talg/coalescing_signal.h>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+using namespace Talg;
+
+namespace {
+	//累加数量,价格取最新的
+	struct AddQuantity {
+		void operator()(std::tuple<int, double>& pending, std::tuple<int, double>&& latest)const {
+			std::get<0>(pending) += std::get<0>(latest);
+			std::get<1>(pending) = std::get<1>(latest);
+		}
+	};
+}
+
+TEST_CASE("Coalescing Signal") {
+	CoalescingSignal<void(const std::string&)> sig;
+	std::vector<std::string> got;
+	sig += [&got](const std::string& s) { got.push_back(s); };
+	CHECK(!sig.flush());
+	for (int i = 0; i < 100; ++i) {
+		sig(std::to_string(i));
+	}
+	CHECK(sig.dirty());
+	CHECK(got.empty());
+	CHECK(sig.flush());
+	CHECK(got == std::vector<std::string>{ "99" });
+	CHECK(sig.coalesced() == 99);
+	CHECK(!sig.dirty());
+	CHECK(!sig.flush());
+
+	sig.emit("x");
+	sig.discard();
+	CHECK(!sig.flush());
+	CHECK(got.size() == 1);
+}
+
+TEST_CASE("Coalescing Signal Reducer") {
+	CoalescingSignal<void(int, double), AddQuantity> trades;
+	int total = 0;
+	double price = 0;
+	trades += [&](int qty, double px) { total += qty; price = px; };
+	trades(10, 1.5);
+	trades(5, 1.25);
+	trades(1, 2.0);
+	trades.flush();
+	CHECK(total == 16);
+	CHECK(price == 2.0);
+}
+
+TEST_CASE("Coalescing Registry") {
+	CoalescingRegistry registry;
+	CoalescingSignal<void(int)> a(registry);
+	auto b = std::make_unique<CoalescingSignal<void(int)>>(registry);
+	CoalescingSignal<void(int)> c(registry);
+	int sum = 0;
+	a += [&](int v) {
+		sum += v;
+		//flush期间再次emit的留待下一帧
+		c(1000);
+	};
+	*b += [&](int v) { sum += v * 10; };
+	c += [&](int v) { sum += v * 100; };
+
+	a(1); a(2);
+	b->emit(3);
+	CHECK(registry.dirty_count() == 2);
+	CHECK(registry.flush_all() == 2);
+	CHECK(sum == 2 + 30);
+	CHECK(registry.dirty_count() == 1);
+	CHECK(registry.flush_all() == 1);
+	CHECK(sum == 32 + 100000);
+	CHECK(registry.flush_all() == 0);
+
+	b->emit(4);
+	b.reset();
+	CHECK(registry.flush_all() == 0);
+}
@@ -0,0 +1,81 @@
+#include <doctest/doctest.h>
+#include <Talg/slotlist.h>
+#include <Talg/combiner.h>
+#include <Talg/thread_pool.h>
+#include <iterator>
+#include <string>
+#include <vector>
+using namespace Talg;
+
+TEST_CASE("Short Circuit Combiner") {
+	int calls = 0;
+	SimpleSignal<bool(int)> veto;
+	veto += [&calls](int v) { ++calls; return v > 0; };
+	veto += [&calls](int v) { ++calls; return v > 10; };
+	veto += [&calls](int v) { ++calls; return v > 100; };
+
+	CHECK(!veto.collect(AllTrue{}, 5));
+	CHECK(calls == 2);
+	calls = 0;
+	CHECK(veto.collect(AllTrue{}, 500));
+	CHECK(calls == 3);
+	calls = 0;
+	CHECK(veto.collect(AnyTrue{}, 5));
+	CHECK(calls == 1);
+	calls = 0;
+	CHECK(!veto.collect(AnyTrue{}, -1));
+	CHECK(calls == 3);
+
+	SimpleSignal<bool()> none;
+	CHECK(none.collect(AllTrue{}));
+	CHECK(!none.collect(AnyTrue{}));
+
+	calls = 0;
+	SimpleSignal<const char*(int)> lookup;
+	lookup += [&calls](int) -> const char* { ++calls; return nullptr; };
+	lookup += [&calls](int v) -> const char* { ++calls; return v == 1 ? "one" : nullptr; };
+	lookup += [&calls](int) -> const char* { ++calls; return "other"; };
+	CHECK(std::string(lookup.collect(FirstNonEmpty{}, 1)) == "one");
+	CHECK(calls == 2);
+	CHECK(std::string(lookup.collect(FirstNonEmpty{}, 2)) == "other");
+}
+
+TEST_CASE("Reducing Combiner") {
+	SimpleSignal<int(int)> sig;
+	sig += [](int v) { return v * 3; };
+	sig += [](int v) { return v - 7; };
+	auto blocked = sig + [](int v) { return v * 100; };
+	blocked->block();
+	sig += [](int v) { return v; };
+
+	CHECK(*sig.collect(MinOf<int>{}, 2) == -5);
+	CHECK(*sig.collect(MaxOf<int>{}, 2) == 6);
+	CHECK(sig.collect(Sum<int>{}, 2) == 6 - 5 + 2);
+	CHECK(sig.collect(Sum<long>(1000), 2) == 1003);
+
+	SimpleSignal<int(int)> none;
+	CHECK(!none.collect(MinOf<int>{}, 1));
+
+	ThreadPool pool(2);
+	CHECK(sig.collect_parallel(pool, Sum<int>{}, 2) == 3);
+	CHECK(*sig.collect_parallel(pool, MaxOf<int>{}, 2) == 6);
+	CHECK(!sig.collect_parallel(pool, AllTrue{}, 0));
+}
+
+TEST_CASE("Collect Into Buffer") {
+	int calls = 0;
+	SimpleSignal<std::string()> sig;
+	for (int i = 0; i < 5; ++i) {
+		sig += [&calls, i] { ++calls; return std::to_string(i); };
+	}
+	std::string buf[3];
+	auto end = sig.collect(collectInto(std::begin(buf), std::end(buf)));
+	CHECK(end == std::end(buf));
+	CHECK(buf[2] == "2");
+	CHECK(calls == 3);
+
+	std::vector<std::string> all;
+	sig.collect(collectInto(std::back_inserter(all)));
+	CHECK(all.size() == 5);
+	CHECK(all.back() == "4");
+}
@@ -0,0 +1,96 @@
+#include <doctest/doctest.h>
+#include <Talg/concurrent_signal.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+using namespace Talg;
+
+namespace {
+	void addOne(int& val) {
+		++val;
+	}
+}
+
+TEST_CASE("Concurrent Signal Basic") {
+	ConcurrentSignal<void(int&)> sig;
+	CHECK(sig.empty());
+	int count = 0;
+	sig += addOne;
+	auto con = sig.connect([](int& val) { val += 10; });
+	sig(count);
+	CHECK(count == 11);
+
+	con->block();
+	CHECK(con.is_blocked());
+	sig(count);
+	CHECK(count == 12);
+	con->unblock();
+
+	sig -= addOne;
+	sig(count);
+	CHECK(count == 22);
+
+	CHECK(con.disconnect());
+	CHECK(!con.is_connected());
+	CHECK(sig.empty());
+	CHECK(!con.disconnect());
+}
+
+TEST_CASE("Concurrent Signal Collect") {
+	ConcurrentSignal<int(int)> sig;
+	sig += [](int v) { return v; };
+	sig += [](int v) { return v * 2; };
+	sig += [](int v) { return v * 3; };
+	int sum = sig.collect([](auto first, auto last, auto&) {
+		int res = 0;
+		for (; first != last; ++first) {
+			if (first) {
+				res += *first;
+			}
+		}
+		return res;
+	}, 2);
+	CHECK(sum == 12);
+}
+
+TEST_CASE("Concurrent Signal Connect During Emit") {
+	ConcurrentSignal<void()> sig;
+	int count = 0;
+	auto cnt = [&count] { ++count; };
+	sig += [&sig, cnt] { sig += cnt; };
+	sig();
+	CHECK(count == 0);
+	sig();
+	CHECK(count == 1);
+}
+
+TEST_CASE("Concurrent Signal Multi Thread") {
+	ConcurrentSignal<void(std::atomic<long>&)> sig;
+	std::atomic<long> calls{ 0 };
+	std::atomic<bool> stop{ false };
+	sig += [](std::atomic<long>& c) { c.fetch_add(1, std::memory_order_relaxed); };
+
+	std::vector<std::thread> emitters;
+	for (int i = 0; i < 4; ++i) {
+		emitters.emplace_back([&] {
+			while (!stop.load()) {
+				sig(calls);
+			}
+		});
+	}
+	for (int i = 0; i < 2000; ++i) {
+		auto con = sig.connect([](std::atomic<long>& c) { c.fetch_add(1, std::memory_order_relaxed); });
+		if (i % 2) {
+			con.disconnect();
+		}
+	}
+	stop = true;
+	for (auto& th : emitters) {
+		th.join();
+	}
+	sig.disconnect_all();
+	CHECK(sig.empty());
+	CHECK(calls.load() > 0);
+	EpochDomain::instance().collect();
+	CHECK(EpochDomain::instance().pending() == 0);
+}
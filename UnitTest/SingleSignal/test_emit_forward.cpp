@@ -0,0 +1,99 @@
+#include <doctest/doctest.h>
+#include <Talg/slotlist.h>
+#include <Talg/static_signal.h>
+#include <Talg/homogeneous_signal.h>
+#include <functional>
+#include <string>
+#include <utility>
+using namespace Talg;
+
+namespace {
+	struct Payload {
+		static int copies;
+		static int moves;
+		std::string data;
+		Payload(std::string s) :data(std::move(s)) {}
+		Payload(const Payload& rhs) :data(rhs.data) { ++copies; }
+		Payload(Payload&& rhs)noexcept :data(std::move(rhs.data)) { ++moves; }
+		static void clear() {
+			copies = 0;
+			moves = 0;
+		}
+	};
+	int Payload::copies = 0;
+	int Payload::moves = 0;
+}
+
+TEST_CASE("Emit Move Into Last Slot") {
+	SimpleSignal<void(Payload, int)> sig;
+	std::string got;
+	sig += [&got](const Payload& p) { got += p.data; };
+	sig += [&got](const Payload& p, int n) { got += p.data + std::to_string(n); };
+	auto last = sig + [&got](Payload p) { got += p.data; };
+
+	Payload::clear();
+	sig.emit(Payload("x"), 1);
+	CHECK(got == "xx1x");
+	//每个槽的std::function按值接收一次,最后一个槽为移动
+	CHECK(Payload::copies == 2);
+
+	//最后一个槽被阻塞时所有的槽都只得到const&
+	auto blocked = sig + [&got](Payload) { got += "never"; };
+	blocked->block();
+	got.clear();
+	Payload::clear();
+	sig.emit(Payload("x"), 1);
+	CHECK(got == "xx1x");
+	CHECK(Payload::copies == 3);
+
+	//只有一个槽时没有任何复制
+	SimpleSignal<void(Payload)> single;
+	single += [&got](Payload p) { got = p.data; };
+	Payload::clear();
+	single.emit(Payload("y"));
+	CHECK(got == "y");
+	CHECK(Payload::copies == 0);
+}
+
+TEST_CASE("Emit Into Slot Unblocked During Emit") {
+	SimpleSignal<void(std::string)> sig;
+	std::string got;
+	SimpleSignal<void(std::string)>::Connection tail;
+	sig += [&tail](const std::string&) { tail->unblock(); };
+	sig += [&got](std::string s) { got += "middle:" + s + " "; };
+	tail = sig + [&got](std::string s) { got += "tail:" + s; };
+	tail->block();
+	sig.emit(std::string("payload"));
+	CHECK(got == "middle:payload tail:payload");
+
+	using Homo = HomogeneousSignal<void(std::string), std::function<void(std::string)>>;
+	Homo homo;
+	Homo::Connection back;
+	got.clear();
+	homo.connect([&back](const std::string&) { back.unblock(); });
+	homo.connect([&got](std::string s) { got += "middle:" + s + " "; });
+	back = homo.connect([&got](std::string s) { got += "tail:" + s; });
+	back.block();
+	homo.emit(std::string("payload"));
+	CHECK(got == "middle:payload tail:payload");
+}
+
+TEST_CASE("Static Signal Emit Forward") {
+	std::string got;
+	auto sig = makeStaticSignal<void(int, Payload)>(
+		[&got](int n) { got += std::to_string(n); },
+		[&got](const Payload& p) { got += p.data; },
+		[&got](Payload p) { got += p.data; }
+	);
+	Payload::clear();
+	sig.emit(1, Payload("z"));
+	CHECK(got == "1zz");
+	CHECK(Payload::copies == 0);
+
+	//最后一个槽被屏蔽时,倒数第二个槽得到右值
+	sig.block<2>();
+	Payload::clear();
+	sig.emit(2, Payload("w"));
+	CHECK(got == "1zz2w");
+	CHECK(Payload::copies == 0);
+}
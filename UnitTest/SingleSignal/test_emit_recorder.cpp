@@ -0,0 +1,89 @@
+#include <doctest/doctest.h>
+#include <Talg/emit_recorder.h>
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+using namespace Talg;
+
+TEST_CASE("Emit Recorder Replay") {
+	EmitRecorder recorder;
+	RecordedSignal<void(int, const std::string&)> named(recorder, 1);
+	RecordedSignal<void(double)> value(recorder, 2);
+	int calls = 0;
+	named += [&calls](int, const std::string&) { ++calls; };
+	named(1, "a");
+	value(0.5);
+	named.detach();
+	named(2, "ignored");
+	named.attach(recorder, 1);
+	named(3, std::string("bc"));
+	CHECK(calls == 3);
+	CHECK(recorder.size() == 3);
+
+	std::stringstream file;
+	recorder.snapshot().save(file);
+	auto trace = EmitTrace::load(file);
+	CHECK(trace.size() == 3);
+
+	//回放给新连接的信号
+	SimpleSignal<void(int, const std::string&)> target;
+	std::vector<std::pair<int, std::string>> got;
+	target += [&got](int i, const std::string& s) { got.emplace_back(i, s); };
+	std::vector<double> values;
+	EmitReplayer replayer;
+	replayer.bind(1, target);
+	replayer.bind_as<void(double)>(2, [&values](double v) { values.push_back(v); });
+	CHECK(replayer.replay(trace) == 3);
+	CHECK(got == std::vector<std::pair<int, std::string>>{ { 1, "a" }, { 3, "bc" } });
+	CHECK(values == std::vector<double>{ 0.5 });
+
+	replayer.unbind(2);
+	CHECK(replayer.replay(trace, ReplaySpeed::recorded) == 2);
+	CHECK(got.size() == 4);
+}
+
+TEST_CASE("Emit Recorder Ring Buffer") {
+	//每条记录为头部加一个int
+	BasicEmitRecorder<> recorder(3 * (sizeof(EmitRecordHeader) + sizeof(int)) + 5);
+	for (int i = 0; i < 10; ++i) {
+		CHECK(recorder.record(0, i));
+	}
+	CHECK(recorder.size() == 3);
+	CHECK(recorder.dropped() == 7);
+	std::vector<int> got;
+	EmitReplayer replayer;
+	replayer.bind_as<void(int)>(0, [&got](int i) { got.push_back(i); });
+	replayer.replay(recorder.snapshot());
+	CHECK(got == std::vector<int>{ 7, 8, 9 });
+
+	CHECK(!recorder.record(0, std::string(1000, 'x')));
+	recorder.clear();
+	CHECK(recorder.snapshot().empty());
+}
+
+TEST_CASE("Emit Recorder Concurrent Clear") {
+	//record可以在任意线程中调用,与clear同时进行时不能出现数据竞争
+	EmitRecorder recorder(4096);
+	std::atomic<bool> clearing{ false };
+	std::atomic<bool> done{ false };
+	std::thread writer([&] {
+		while (!clearing) {
+			std::this_thread::yield();
+		}
+		for (int i = 0; i < 2000; ++i) {
+			recorder.record(0, i);
+		}
+		done = true;
+	});
+	while (!done) {
+		recorder.clear();
+		clearing = true;
+	}
+	writer.join();
+	recorder.snapshot().for_each([](const EmitRecordHeader& head, ByteReader&) {
+		CHECK(head.time >= 0);
+	});
+}
@@ -0,0 +1,75 @@
+#include <doctest/doctest.h>
+#include <Talg/event_bus.h>
+#include <string>
+#include <vector>
+using namespace Talg;
+
+namespace {
+	struct Click :EventTopic<void(int, int)> {
+		static constexpr auto name() { return makeCtString("click"); }
+	};
+	struct Key :EventTopic<void(char)> {
+		static constexpr auto name() { return makeCtString("key"); }
+	};
+	struct Log :EventTopic<void(const std::string&)> {
+		static constexpr auto name() { return makeCtString("log"); }
+	};
+	//名字不同但长度相同
+	struct Lag :EventTopic<void()> {
+		static constexpr auto name() { return makeCtString("lag"); }
+	};
+}
+
+TEST_CASE("Event Bus") {
+	using Bus = EventBus<Click, Key, Log, Lag>;
+	static_assert(Bus::index_of<Log>() == 2, "");
+	static_assert(Bus::index_of<int>() == no_index, "");
+	Bus bus;
+	int x = 0, y = 0;
+	std::string keys;
+	std::vector<std::string> logs;
+	int lags = 0;
+	bus.subscribe<Click>([&](int a, int b) { x += a; y += b; });
+	bus.subscribe<Key>([&keys](char c) { keys += c; });
+	bus.get<Log>() += [&logs](const std::string& s) { logs.push_back(s); };
+	bus.subscribe<Lag>([&lags] { ++lags; });
+
+	bus.publish<Click>(1, 2);
+	bus.publish<Key>('a');
+	bus.publish<Log>("hello");
+	CHECK(x == 1);
+	CHECK(y == 2);
+	CHECK(keys == "a");
+	CHECK(logs == std::vector<std::string>{ "hello" });
+
+	CHECK(Bus::find("click") == 0);
+	CHECK(Bus::find("lag") == 3);
+	CHECK(Bus::find("clack") == ctStringBase::npos);
+	CHECK(Bus::find("") == ctStringBase::npos);
+	CHECK(bus.publish("click", 10, 20));
+	CHECK(bus.publish(std::string("key"), 'b'));
+	CHECK(bus.publish("log", std::string("world")));
+	CHECK(bus.publish("lag"));
+	CHECK(x == 11);
+	CHECK(keys == "ab");
+	CHECK(logs.size() == 2);
+	CHECK(lags == 1);
+
+	//参数与签名不符或没有该主题
+	CHECK(!bus.publish("click", 1));
+	CHECK(!bus.publish("key", std::string("c")));
+	CHECK(!bus.publish("mouse", 1, 2));
+	CHECK(x == 11);
+	CHECK(keys == "ab");
+}
+
+TEST_CASE("Perfect Hash Table") {
+	constexpr std::uint64_t keys[] = { 1, 2, 3, 100, 1000, 77777, 5, 6, 7, 8, 9, 10, 11 };
+	constexpr auto table = makePerfectHash(keys);
+	static_assert(table.valid, "");
+	for (std::size_t i = 0; i != 13; ++i) {
+		CHECK(table.find(keys[i]) == i);
+	}
+	constexpr std::uint64_t dup[] = { 1, 2, 1 };
+	static_assert(!makePerfectHash(dup).valid, "");
+}
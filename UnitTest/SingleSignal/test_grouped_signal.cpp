@@ -0,0 +1,65 @@
+#include <doctest/doctest.h>
+#include <Talg/grouped_signal.h>
+#include <string>
+using namespace Talg;
+
+namespace {
+	auto append(std::string& log, const char* tag) {
+		return [&log, tag] { log += tag; };
+	}
+}
+
+TEST_CASE("Grouped Signal Order") {
+	GroupedSignal<void(), int> sig;
+	std::string log;
+	CHECK(sig.empty());
+	sig += append(log, "u");
+	sig.connect_group(2, append(log, "b"));
+	sig.connect_group(1, append(log, "a"));
+	sig.connect_group(2, append(log, "c"));
+	sig.connect_group_front(2, append(log, "B"));
+	sig.connect_front(append(log, "F"));
+	sig.connect_group(3, append(log, "d"));
+	CHECK(!sig.empty());
+	sig();
+	CHECK(log == "FaBbcdu");
+
+	sig.disconnect_group(2);
+	log.clear();
+	sig();
+	CHECK(log == "Fadu");
+
+	sig.connect_group(2, append(log, "x"));
+	log.clear();
+	sig();
+	CHECK(log == "Faxdu");
+}
+
+TEST_CASE("Grouped Signal Connection") {
+	GroupedSignal<void(), std::string> sig;
+	std::string log;
+	auto a = sig.connect_group("alpha", append(log, "a"));
+	auto b = sig.connect_group("beta", append(log, "b"));
+	auto a2 = sig.connect_group("alpha", append(log, "A"));
+	auto u = sig.connect(append(log, "u"));
+	sig();
+	CHECK(log == "aAbu");
+
+	//删除组内最后一个槽之后,组尾的插入位置依然正确
+	a2->disconnect();
+	b->disconnect();
+	sig.connect_group("alpha", append(log, "2"));
+	sig.connect_group("beta", append(log, "3"));
+	log.clear();
+	sig();
+	CHECK(log == "a23u");
+
+	sig.disconnect_all();
+	CHECK(sig.empty());
+	CHECK(a->is_disconnected());
+	CHECK(u->is_disconnected());
+	sig.connect_group("beta", append(log, "b"));
+	log.clear();
+	sig();
+	CHECK(log == "b");
+}
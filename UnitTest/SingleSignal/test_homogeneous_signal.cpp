@@ -0,0 +1,118 @@
+#include <doctest/doctest.h>
+#include <Talg/homogeneous_signal.h>
+#include <Talg/combiner.h>
+#include <functional>
+#include <vector>
+using namespace Talg;
+
+namespace {
+	struct Counter {
+		int sum = 0;
+		void add(int v) {
+			sum += v;
+		}
+		int get(int v)const {
+			return sum + v;
+		}
+	};
+	//相等比较只看tag,trigger==tag时在emit期间修改所在的信号
+	struct Tagged {
+		int tag;
+		HomogeneousSignal<void(int), Tagged>* sig = nullptr;
+		void operator()(int trigger)const {
+			if (sig != nullptr && trigger == tag) {
+				sig->connect(Tagged{ 7 });
+				sig->disconnect_one(Tagged{ 7 });
+			}
+		}
+		bool operator==(const Tagged& rhs)const noexcept {
+			return tag == rhs.tag;
+		}
+	};
+}
+
+TEST_CASE("Homogeneous Signal") {
+	using Sig = MemberSignal<void(int), Counter, void(Counter::*)(int)>;
+	Sig sig;
+	std::vector<Counter> objs(4);
+	std::vector<Sig::Connection> cons;
+	for (auto& obj : objs) {
+		cons.push_back(sig.connect(&obj, &Counter::add));
+	}
+	CHECK(sig.size() == 4);
+	sig(1);
+	sig.emit(2);
+	for (auto& obj : objs) {
+		CHECK(obj.sum == 3);
+	}
+	//槽以具体的类型连续保存,可以直接取得对象指针
+	CHECK(sig.slots()[2].func.object() == &objs[2]);
+
+	cons[1].block();
+	sig(1);
+	CHECK(objs[1].sum == 3);
+	CHECK(objs[2].sum == 4);
+	cons[1].unblock();
+	CHECK(cons[0].disconnect());
+	CHECK(!cons[0].disconnect());
+	CHECK(!cons[0].is_connected());
+	sig.disconnect(MemFun<Counter*, void(Counter::*)(int), void(int)>(&objs[3], &Counter::add));
+	CHECK(sig.size() == 2);
+	sig(1);
+	CHECK(objs[0].sum == 4);
+	CHECK(objs[1].sum == 4);
+	CHECK(objs[2].sum == 5);
+	CHECK(objs[3].sum == 4);
+	CHECK(cons[2].is_connected());
+	sig.disconnect_all();
+	CHECK(sig.empty());
+	CHECK(!cons[2].is_connected());
+}
+
+TEST_CASE("Homogeneous Signal Reentrancy") {
+	using F = std::function<void(int)>;
+	HomogeneousSignal<void(int), F> sig;
+	std::vector<int> order;
+	HomogeneousSignal<void(int), F>::Connection self;
+	sig.connect([&](int v) {
+		order.push_back(v);
+		if (v == 0) {
+			//emit期间的修改在最外层的emit结束之后才生效
+			self.disconnect();
+			sig.connect([&order](int x) { order.push_back(x + 100); });
+			sig(1);
+		}
+	});
+	self = sig.connect([&order](int v) { order.push_back(v + 10); });
+	sig(0);
+	CHECK(order == std::vector<int>{ 0, 1 });
+	CHECK(sig.size() == 2);
+	order.clear();
+	sig(2);
+	CHECK(order == std::vector<int>{ 2, 102 });
+}
+
+TEST_CASE("Homogeneous Signal Disconnect One During Emit") {
+	HomogeneousSignal<void(int), Tagged> sig;
+	sig.connect(Tagged{ 7 });
+	sig.connect(Tagged{ 1, &sig });
+	//emit期间连接的槽在pending_中,disconnect_one只删除原有的那一个
+	sig(1);
+	CHECK(sig.size() == 2);
+	CHECK(sig.slots().size() == 2);
+	CHECK(sig.slots()[0].func.tag == 1);
+	CHECK(sig.slots()[1].func.tag == 7);
+}
+
+TEST_CASE("Homogeneous Signal Collect") {
+	MemberSignal<int(int), const Counter, int(Counter::*)(int)const> sig;
+	Counter a, b;
+	a.sum = 5;
+	b.sum = 1;
+	sig.connect(&a, &Counter::get);
+	auto con = sig.connect(&b, &Counter::get);
+	CHECK(*sig.collect(MinOf<int>{}, 10) == 11);
+	CHECK(sig.collect(Sum<int>{}, 0) == 6);
+	con.block();
+	CHECK(*sig.collect(MaxOf<int>{}, 0) == 5);
+}
@@ -0,0 +1,87 @@
+#include <doctest/doctest.h>
+#include <Talg/indexed_signal.h>
+#include <memory>
+#include <vector>
+using namespace Talg;
+
+namespace {
+	struct Counter {
+		int count = 0;
+		void add(int v) { count += v; }
+		void twice(int v) { count += 2 * v; }
+	};
+	void addTo(int& total, int v) {
+		total += v;
+	}
+}
+
+TEST_CASE("Indexed Signal Member Function") {
+	IndexedSignal<void(int)> sig;
+	std::vector<Counter> objs(1000);
+	for (auto& obj : objs) {
+		sig.connect(&obj, &Counter::add);
+		sig.connect(&obj, &Counter::twice);
+	}
+	sig(1);
+	CHECK(objs[10].count == 3);
+
+	sig.disconnect(&objs[10], &Counter::add);
+	sig.disconnect_one(&objs[20], &Counter::twice);
+	sig(1);
+	CHECK(objs[10].count == 5);
+	CHECK(objs[20].count == 4);
+	CHECK(objs[30].count == 6);
+
+	//对象指针为空时按成员指针删除,退化为线性查找
+	sig.disconnect(static_cast<Counter*>(nullptr), &Counter::twice);
+	sig(1);
+	CHECK(objs[30].count == 7);
+	CHECK(objs[10].count == 5);
+
+	for (auto& obj : objs) {
+		sig.disconnect(&obj, &Counter::add);
+	}
+	CHECK(sig.empty());
+}
+
+TEST_CASE("Indexed Signal Functor") {
+	IndexedSignal<void(int)> sig;
+	int total = 0;
+	auto lambda = [&total](int v) { total += 10 * v; };
+	auto con = sig + lambda;
+	sig += lambda;
+	sig += [&total](int v) { total += 100 * v; };
+	sig(1);
+	CHECK(total == 120);
+
+	sig.disconnect_one(lambda);
+	CHECK(con->is_disconnected());	//删除的是最早连接的那个
+	total = 0;
+	sig(1);
+	CHECK(total == 110);
+
+	sig -= lambda;
+	total = 0;
+	sig(1);
+	CHECK(total == 100);
+}
+
+TEST_CASE("Indexed Signal Stale Entries") {
+	IndexedSignal<void(int&, int)> sig;
+	std::vector<IndexedSignal<void(int&, int)>::Connection> cons;
+	for (int i = 0; i < 200; ++i) {
+		cons.push_back(sig.connect(addTo));
+	}
+	for (auto& con : cons) {
+		con->disconnect();
+	}
+	CHECK(sig.empty());
+	auto con = sig.connect(addTo);
+	int total = 0;
+	sig(total, 3);
+	CHECK(total == 3);
+	sig.disconnect(addTo);
+	CHECK(con->is_disconnected());
+	CHECK(sig.empty());
+	CHECK(sig.index_size() == 0);	//查找时顺带清除了同一个桶中失效的项
+}
@@ -0,0 +1,48 @@
+#include <doctest/doctest.h>
+#include <Talg/lazy_signal.h>
+#include <Talg/combiner.h>
+#include <string>
+#include <utility>
+using namespace Talg;
+
+TEST_CASE("Lazy Signal") {
+	static_assert(sizeof(LazySignal<void(int)>) == sizeof(void*), "");
+	LazySignal<void(int)> sig;
+	CHECK(sig.empty());
+	sig(1);
+	sig.emit(2);
+	sig.disconnect_all();
+	CHECK(!sig.allocated());
+
+	int sum = 0;
+	auto f = [&sum](int v) { sum += v; };
+	sig += f;
+	CHECK(sig.allocated());
+	CHECK(!sig.empty());
+	auto con = sig.connect([&sum](int v) { sum += v * 10; });
+	sig(1);
+	sig.emit(2);
+	CHECK(sum == 33);
+	con->disconnect();
+	sig -= f;
+	CHECK(sig.empty());
+	CHECK(sig.allocated());
+	sig(1);
+	CHECK(sum == 33);
+
+	LazySignal<void(int)> other(std::move(sig));
+	other += f;
+	other(1);
+	CHECK(sum == 34);
+}
+
+TEST_CASE("Lazy Signal Collect") {
+	LazySignal<int(int)> sig;
+	CHECK(!sig.collect(MinOf<int>{}, 1));
+	CHECK(sig.collect(Sum<int>{}, 1) == 0);
+	CHECK(!sig.allocated());
+	sig += [](int v) { return v + 1; };
+	sig += [](int v) { return v * 3; };
+	CHECK(*sig.collect(MaxOf<int>{}, 5) == 15);
+	CHECK(sig.collect_guarded(Sum<int>{}, 1) == 5);
+}
@@ -0,0 +1,81 @@
+#include <doctest/doctest.h>
+#include <Talg/slotlist.h>
+#include <Talg/thread_pool.h>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+using namespace Talg;
+
+namespace {
+	struct SumCombiner {
+		static constexpr bool is_associative = true;
+		long init()const { return 0; }
+		long fold(long acc, int res)const { return acc + res; }
+		long merge(long lhs, long rhs)const { return lhs + rhs; }
+	};
+	//满足结合律但不满足交换律,用于检查结果的顺序
+	struct ConcatCombiner {
+		static constexpr bool is_associative = true;
+		std::string init()const { return std::string(); }
+		std::string fold(std::string acc, const std::string& res)const { return acc + res; }
+		std::string merge(std::string lhs, const std::string& rhs)const { return lhs + rhs; }
+	};
+}
+
+TEST_CASE("Parallel Collect") {
+	ThreadPool pool(4);
+	SimpleSignal<int(int)> sig;
+	for (int i = 0; i < 300; ++i) {
+		sig += [i](int v) { return i * v; };
+	}
+	CHECK(sig.collect_parallel(pool, SumCombiner{}, 2) == 2 * (299 * 300 / 2));
+	InlineExecutor inline_exec;
+	CHECK(sig.collect_parallel(inline_exec, SumCombiner{}, 1) == 299 * 300 / 2);
+
+	SimpleSignal<std::string()> names;
+	std::string expect;
+	for (int i = 0; i < 100; ++i) {
+		auto name = std::to_string(i);
+		expect += name;
+		names += [name] { return name; };
+	}
+	CHECK(names.collect_parallel(pool, ConcatCombiner{}) == expect);
+
+	SimpleSignal<std::string()> none;
+	CHECK(none.collect_parallel(pool, ConcatCombiner{}).empty());
+}
+
+TEST_CASE("Parallel Emit") {
+	ThreadPool pool(3);
+	SimpleSignal<void(std::atomic<int>&)> sig;
+	for (int i = 0; i < 50; ++i) {
+		sig += [](std::atomic<int>& v) { ++v; };
+	}
+	auto blocked = sig + [](std::atomic<int>& v) { v += 1000; };
+	blocked->block();
+	std::atomic<int> count{ 0 };
+	sig.emit_parallel(pool, count);
+	CHECK(count == 50);
+
+	sig += [](std::atomic<int>&) { throw std::runtime_error("slot failed"); };
+	CHECK_THROWS_AS(sig.emit_parallel(pool, count), std::runtime_error);
+	CHECK(count == 100);
+}
+
+TEST_CASE("Nested Parallel Emit") {
+	//槽中再次并行emit:池中的线程都在等待时,排队的辅助任务不能成为等待的条件
+	ThreadPool pool(2);
+	SimpleSignal<void(int)> inner;
+	std::atomic<int> total{ 0 };
+	for (int i = 0; i < 20; ++i) {
+		inner += [&total](int v) { total += v; };
+	}
+	SimpleSignal<void(int)> outer;
+	for (int i = 0; i < 20; ++i) {
+		outer += [&inner, &pool](int v) { inner.emit_parallel(pool, v); };
+	}
+	for (int round = 0; round < 50; ++round) {
+		outer.emit_parallel(pool, 1);
+	}
+	CHECK(total == 50 * 20 * 20);
+}
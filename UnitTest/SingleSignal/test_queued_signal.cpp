@@ -0,0 +1,89 @@
+#include <doctest/doctest.h>
+#include <Talg/queued_signal.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace Talg;
+
+TEST_CASE("Bounded Queue") {
+	BoundedQueue<std::string> queue(3);
+	CHECK(queue.capacity() == 4);
+	for (int i = 0; i < 4; ++i) {
+		CHECK(queue.try_push(std::to_string(i)));
+	}
+	CHECK(!queue.try_push(std::string("x")));
+	std::string res;
+	CHECK(queue.try_pop([&res](std::string&& s) { res = s; }));
+	CHECK(res == "0");
+	CHECK(queue.try_push(std::string("4")));
+	CHECK(queue.size_approx() == 4);
+}
+
+TEST_CASE("Queued Signal Dispatch") {
+	std::atomic<int> sum{ 0 };
+	std::thread::id caller = std::this_thread::get_id();
+	std::atomic<bool> inline_call{ false };
+	QueuedSignal<void(int, const std::string&)> sig(16);
+	sig += [&](int v, const std::string& s) {
+		sum += v + static_cast<int>(s.size());
+		if (std::this_thread::get_id() == caller) {
+			inline_call = true;
+		}
+	};
+	std::vector<std::thread> producers;
+	for (int i = 0; i < 4; ++i) {
+		producers.emplace_back([&sig] {
+			for (int j = 0; j < 1000; ++j) {
+				sig(1, std::string("ab"));
+			}
+		});
+	}
+	for (auto& th : producers) {
+		th.join();
+	}
+	sig.wait_idle();
+	CHECK(sum == 4 * 1000 * 3);
+	CHECK(sig.dropped() == 0);
+	CHECK(!inline_call);
+}
+
+TEST_CASE("Queued Signal Drop Newest") {
+	std::vector<int> got;
+	QueuedSignal<void(int)> sig(4, OverflowPolicy::drop_newest, 0);
+	sig += [&got](int v) { got.push_back(v); };
+	for (int i = 0; i < 10; ++i) {
+		CHECK(sig.emit(i) == (i < 4));
+	}
+	CHECK(sig.dropped() == 6);
+	CHECK(sig.poll() == 4);
+	CHECK(got == std::vector<int>{ 0, 1, 2, 3 });
+}
+
+TEST_CASE("Queued Signal Drop Oldest") {
+	std::vector<int> got;
+	QueuedSignal<void(int)> sig(4, OverflowPolicy::drop_oldest, 0);
+	sig += [&got](int v) { got.push_back(v); };
+	for (int i = 0; i < 10; ++i) {
+		sig.emit(i);
+	}
+	CHECK(sig.dropped() == 6);
+	CHECK(sig.poll(2) == 2);
+	CHECK(sig.poll() == 2);
+	CHECK(got == std::vector<int>{ 6, 7, 8, 9 });
+	CHECK(sig.pending() == 0);
+}
+
+TEST_CASE("Queued Signal Block") {
+	std::vector<int> got;
+	QueuedSignal<void(int)> sig(2, OverflowPolicy::block, 1, 1);
+	sig += [&got](int v) { got.push_back(v); };
+	for (int i = 0; i < 100; ++i) {
+		sig.emit(i);
+	}
+	sig.wait_idle();
+	CHECK(sig.dropped() == 0);
+	REQUIRE(got.size() == 100);
+	CHECK(got.front() == 0);
+	CHECK(got.back() == 99);
+}
@@ -0,0 +1,142 @@
+#include <doctest/doctest.h>
+#include <Talg/reactor.h>
+#ifdef __linux__
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+using namespace Talg;
+
+TEST_CASE("Reactor Pipe And Socketpair") {
+	Reactor reactor(4);
+	auto pipe = makePipe();
+	std::string got;
+	auto& w = reactor.watch(pipe.first.get(), EPOLLIN, [&](int fd, std::uint32_t events) {
+		CHECK((events & EPOLLIN) != 0);
+		char buf[16];
+		auto n = ::read(fd, buf, sizeof(buf));
+		if (n > 0) {
+			got.append(buf, static_cast<std::size_t>(n));
+		}
+	});
+	CHECK(w.fd() == pipe.first.get());
+	CHECK(reactor.watching(pipe.first.get()));
+	CHECK_THROWS_AS(reactor.watch(pipe.first.get(), EPOLLIN), std::system_error);
+	//无效的fd不影响已有的注册
+	CHECK_THROWS_AS(reactor.watch(-1, EPOLLIN), std::system_error);
+	CHECK(reactor.watching(pipe.first.get()));
+	{
+		UniqueFd closed(::dup(pipe.second.get()));
+		int fd = closed.get();
+		closed.reset();
+		CHECK_THROWS_AS(reactor.watch(fd, EPOLLIN), std::system_error);
+	}
+	CHECK(reactor.size() == 1);
+	CHECK(reactor.watching(pipe.first.get()));
+	CHECK(reactor.run_once(0) == 0);
+	CHECK(::write(pipe.second.get(), "abc", 3) == 3);
+	CHECK(reactor.run_once(100) == 1);
+	CHECK(got == "abc");
+
+	int sv[2];
+	REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, sv) == 0);
+	UniqueFd a(sv[0]), b(sv[1]);
+	int writable = 0;
+	reactor.watch(a.get(), EPOLLOUT, [&](int, std::uint32_t events) {
+		CHECK((events & EPOLLOUT) != 0);
+		++writable;
+	});
+	CHECK(reactor.run_once(100) == 1);
+	CHECK(writable == 1);
+	reactor.modify(a.get(), EPOLLIN);
+	CHECK(reactor.run_once(0) == 0);
+	CHECK(writable == 1);
+	CHECK(reactor.size() == 2);
+	CHECK(reactor.unwatch(a.get()));
+	CHECK(!reactor.unwatch(a.get()));
+	CHECK(reactor.size() == 1);
+}
+
+TEST_CASE("Reactor Unwatch During Dispatch") {
+	Reactor reactor;
+	auto p1 = makePipe();
+	auto p2 = makePipe();
+	int calls = 0;
+	//两个fd在同一批中就绪,先被调用的槽unwatch两者
+	auto handler = [&](int, std::uint32_t) {
+		++calls;
+		reactor.unwatch(p1.first.get());
+		reactor.unwatch(p2.first.get());
+	};
+	reactor.watch(p1.first.get(), EPOLLIN, handler);
+	reactor.watch(p2.first.get(), EPOLLIN, handler);
+	CHECK(::write(p1.second.get(), "x", 1) == 1);
+	CHECK(::write(p2.second.get(), "y", 1) == 1);
+	reactor.run_once(100);
+	CHECK(calls == 1);
+	CHECK(reactor.size() == 0);
+
+	//下标被复用之后不会收到旧注册的事件
+	int fresh = 0;
+	reactor.watch(p1.first.get(), EPOLLIN, [&](int, std::uint32_t) { ++fresh; });
+	reactor.run_once(100);
+	CHECK(fresh == 1);
+}
+
+TEST_CASE("Reactor EventFd TimerFd And Timers") {
+	Reactor reactor;
+	EventFd efd;
+	std::uint64_t total = 0;
+	reactor.watch(efd.get(), EPOLLIN, [&](int, std::uint32_t) { total += efd.drain(); });
+	efd.notify(2);
+	efd.notify(3);
+	reactor.run_once(100);
+	CHECK(total == 5);
+
+	TimerFd tfd;
+	std::uint64_t expired = 0;
+	reactor.watch(tfd.get(), EPOLLIN, [&](int, std::uint32_t) { expired += tfd.expirations(); });
+	tfd.arm(std::chrono::milliseconds(1));
+	while (expired == 0) {
+		reactor.run_once(1000);
+	}
+	CHECK(expired == 1);
+
+	//时间轮的定时器缩短epoll_wait的等待
+	bool fired = false;
+	reactor.timers().schedule_after(std::chrono::milliseconds(5), [&] { fired = true; });
+	auto start = std::chrono::steady_clock::now();
+	while (!fired) {
+		reactor.run_once(-1);
+	}
+	CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(5));
+}
+
+TEST_CASE("Reactor Post And Stop") {
+	Reactor reactor;
+	std::atomic<int> sum{ 0 };
+	std::vector<std::thread> threads;
+	for (int t = 0; t != 4; ++t) {
+		threads.emplace_back([&] {
+			for (int i = 0; i != 1000; ++i) {
+				reactor.post([&] { sum.fetch_add(1, std::memory_order_relaxed); });
+			}
+		});
+	}
+	for (auto& t : threads) {
+		t.join();
+	}
+	reactor.post([&] { reactor.stop(); });
+	reactor.run();
+	CHECK(sum == 4000);
+	CHECK(!reactor.stopped());
+
+	std::thread stopper([&] {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		reactor.stop();
+	});
+	reactor.run();
+	stopper.join();
+}
+#endif //__linux__
@@ -0,0 +1,76 @@
+#include <doctest/doctest.h>
+#include <Talg/signal_ops.h>
+#include <Talg/slotlist.h>
+#include <string>
+#include <tuple>
+#include <vector>
+using namespace Talg;
+
+TEST_CASE("Signal Operators") {
+	SimpleSignal<void(int)> src;
+	SimpleSignal<void(const std::string&)> dst;
+	std::vector<std::string> got;
+	dst += [&got](const std::string& s) { got.push_back(s); };
+
+	auto ops = filter([](int v) { return v % 2 == 0; })
+		| map([](int v) { return v * 10; })
+		| take_while([](int v) { return v < 100; })
+		| map([](int v) { return std::to_string(v); });
+	auto con = pipe(src, ops, dst);
+	for (int i = 0; i != 20; ++i) {
+		src(i);
+	}
+	CHECK(got == std::vector<std::string>{ "0", "20", "40", "60", "80" });
+
+	//链的状态属于每一次连接
+	got.clear();
+	pipe(src, ops, dst);
+	src(2);
+	CHECK(got == std::vector<std::string>{ "20" });
+	con->disconnect();
+
+	//以函数对象作为终点,多个参数的事件保存为tuple
+	SimpleSignal<void(int, char)> pairs;
+	std::vector<std::size_t> sizes;
+	std::tuple<int, char> last{};
+	pipe(pairs, buffer(3), [&](const std::vector<std::tuple<int, char>>& batch) {
+		sizes.push_back(batch.size());
+		last = batch.back();
+	});
+	for (int i = 0; i != 7; ++i) {
+		pairs(i, static_cast<char>('a' + i));
+	}
+	CHECK(sizes == std::vector<std::size_t>{ 3, 3 });
+	CHECK(last == std::make_tuple(5, 'f'));
+}
+
+TEST_CASE("Timed Signal Operators") {
+	using Clock = std::chrono::steady_clock;
+	const Clock::time_point origin{};
+	TimingWheel wheel(1ms, origin);
+	SimpleSignal<void(int)> src;
+	std::vector<int> debounced, sampled;
+	pipe(src, debounce(wheel, 10ms), [&](int v) { debounced.push_back(v); });
+	auto con = pipe(src, map([](int v) { return v + 100; }) | sample(wheel, 5ms),
+		[&](int v) { sampled.push_back(v); });
+
+	for (int t = 0; t != 12; ++t) {
+		src(t);
+		wheel.advance(origin + std::chrono::milliseconds(t + 1));
+	}
+	CHECK(debounced.empty());
+	CHECK(sampled == std::vector<int>{ 104, 109 });
+	wheel.advance(origin + 30ms);
+	CHECK(debounced == std::vector<int>{ 11 });
+	CHECK(sampled == std::vector<int>{ 104, 109, 111 });
+
+	//断开之后未触发的定时器被取消
+	src(50);
+	CHECK(wheel.size() == 2);
+	con->disconnect();
+	CHECK(wheel.size() == 1);
+	src.disconnect_all();
+	CHECK(wheel.empty());
+	wheel.advance(origin + 100ms);
+	CHECK(debounced == std::vector<int>{ 11 });
+}
@@ -0,0 +1,131 @@
+#include <doctest/doctest.h>
+#include <Talg/slot_arena.h>
+#include <Talg/chunk_list.h>
+#include <array>
+#include <type_traits>
+#include <vector>
+using namespace Talg;
+
+namespace {
+	//大于SmallFunction的缓冲区,必须另外分配
+	struct BigSlot {
+		std::array<char, 128> pad{};
+		int* sum;
+		void operator()(int v)const {
+			*sum += v;
+		}
+		bool operator==(const BigSlot& rhs)const noexcept {
+			return sum == rhs.sum;
+		}
+	};
+	//移动赋值时不传播的分配器,用于检查逐个移动元素的路径
+	template<class T>
+	struct StickyArenaAllocator :ArenaAllocator<T> {
+		using propagate_on_container_move_assignment = std::false_type;
+		using ArenaAllocator<T>::ArenaAllocator;
+		template<class U>
+		struct rebind {
+			using other = StickyArenaAllocator<U>;
+		};
+	};
+}
+
+TEST_CASE("Slot Arena") {
+	SlotArena arena(4096);
+	int sum = 0;
+	{
+		ArenaSignal<void(int)> a(arena);
+		ArenaSignal<void(int)> b(arena);
+		auto con = a.connect([&sum](int v) { sum += v; });
+		static_assert(sizeof(con) == 2 * sizeof(void*), "Connection carries the allocator");
+		b += BigSlot{ {}, &sum };
+		CHECK(arena.bytes_in_use() != 0);
+		auto used = arena.bytes_in_use();
+		a(1);
+		b(10);
+		CHECK(sum == 11);
+		con->disconnect();
+		a(1);
+		CHECK(sum == 11);
+		CHECK(arena.bytes_in_use() < used);
+
+		//断开之后空闲的内存被再次使用
+		auto reserved = arena.bytes_reserved();
+		for (int i = 0; i < 100; ++i) {
+			auto c = a.connect([&sum](int v) { sum += v; });
+			c->disconnect();
+		}
+		CHECK(arena.bytes_reserved() == reserved);
+		b -= BigSlot{ {}, &sum };
+		CHECK(b.empty());
+	}
+	CHECK(arena.bytes_in_use() == 0);
+	CHECK(arena.bytes_reserved() != 0);
+	arena.release();
+	CHECK(arena.bytes_reserved() == 0);
+}
+
+TEST_CASE("Arena Allocator") {
+	SlotArena arena;
+	std::vector<int, ArenaAllocator<int>> vec{ ArenaAllocator<int>(arena) };
+	for (int i = 0; i < 1000; ++i) {
+		vec.push_back(i);
+	}
+	CHECK(vec[999] == 999);
+	CHECK(ArenaAllocator<int>(arena) == ArenaAllocator<char>(arena));
+	CHECK(ArenaAllocator<int>() != ArenaAllocator<int>(arena));
+
+	//默认构造的分配器使用全局的operator new
+	ArenaSignal<void(int)> sig;
+	int sum = 0;
+	sig += [&sum](int v) { sum += v; };
+	sig(3);
+	CHECK(sum == 3);
+
+	SmallFunction<void(int), 16> f(std::allocator_arg, ArenaAllocator<char>(arena), BigSlot{ {}, &sum });
+	CHECK(!f.is_inline());
+	auto g = f;
+	g(1);
+	CHECK(sum == 4);
+	CHECK(f == g);
+	//目标的类型与分配方式无关
+	SmallFunction<void(int), 16> h(BigSlot{ {}, &sum });
+	CHECK(f == h);
+	CHECK(f.target<BigSlot>() != nullptr);
+	CHECK(f.target<BigSlot>()->sum == &sum);
+	SmallFunction<void(int), 16> s(std::allocator_arg, std::allocator<char>(), BigSlot{ {}, &sum });
+	CHECK(s == h);
+}
+
+TEST_CASE("Chunk List Move Assign Across Arenas") {
+	SlotArena arena_a(4096);
+	SlotArena arena_b(4096);
+	{
+		ChunkList<int, ArenaAllocator<int>> x(arena_a), y(arena_b);
+		x.push_back(1);
+		y.push_back(2);
+		x = std::move(y);
+		//块随分配器一起转移,由arena_b释放
+		CHECK(x.get_allocator() == ArenaAllocator<int>(arena_b));
+		CHECK(x.front() == 2);
+		CHECK(y.empty());
+		CHECK(arena_a.bytes_in_use() == 0);
+	}
+	CHECK(arena_a.bytes_in_use() == 0);
+	CHECK(arena_b.bytes_in_use() == 0);
+	{
+		ChunkList<int, StickyArenaAllocator<int>> x(arena_a), y(arena_b);
+		x.push_back(1);
+		y.push_back(2);
+		y.push_back(3);
+		x = std::move(y);
+		CHECK(x.get_allocator() == ArenaAllocator<int>(arena_a));
+		CHECK(x.front() == 2);
+		CHECK(x.back() == 3);
+		CHECK(y.empty());
+		y.push_back(4);
+		CHECK(y.front() == 4);
+	}
+	CHECK(arena_a.bytes_in_use() == 0);
+	CHECK(arena_b.bytes_in_use() == 0);
+}
@@ -0,0 +1,270 @@
+#include <doctest/doctest.h>
+#include <Talg/slotlist.h>
+#include <Talg/intrusive_slot_traits.h>
+#include <Talg/instrumented_slot.h>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <array>
+using namespace Talg;
+
+TEST_CASE("ChunkList") {
+	ChunkList<std::string> list;
+	CHECK(list.empty());
+	for (int i = 0; i < 100; ++i) {
+		list.emplace_back(std::to_string(i));
+	}
+	CHECK(list.front() == "0");
+	CHECK(list.back() == "99");
+	auto cap = list.capacity();
+	CHECK(cap >= 100);
+
+	list.remove_if([](const std::string& s) { return s.size() == 1; });
+	CHECK(list.front() == "10");
+	for (int i = 0; i < 10; ++i) {
+		list.emplace_back("x");
+	}
+	CHECK(list.capacity() == cap);	//被删除的节点被复用
+
+	ChunkList<std::string> copy = list;
+	ChunkList<std::string> moved = std::move(list);
+	CHECK(list.empty());
+	CHECK(copy.back() == "x");
+	CHECK(moved.back() == "x");
+	moved.emplace_back("y");
+	CHECK(moved.back() == "y");
+}
+
+TEST_CASE("Pooled Signal") {
+	PooledSignal<void(int)> sig;
+	int sum = 0;
+	auto add = [&sum](int v) { sum += v; };
+	std::vector<PooledSignal<void(int)>::Connection> cons;
+	for (int i = 0; i < 10; ++i) {
+		cons.push_back(sig.connect(add));
+	}
+	sig(1);
+	CHECK(sum == 10);
+
+	cons[0]->disconnect();
+	cons[5]->disconnect();
+	cons[9]->disconnect();
+	sum = 0;
+	sig(1);
+	CHECK(sum == 7);
+
+	sig.disconnect(add);
+	CHECK(sig.empty());
+	for (auto& con : cons) {
+		CHECK(con->is_disconnected());
+	}
+}
+
+TEST_CASE("Pooled Signal Mutation During Emit") {
+	PooledSignal<void()> sig;
+	int count = 0;
+	bool once = true;
+	auto cnt = [&count] { ++count; };
+	PooledSignal<void()>::Connection con;
+	auto self = sig + [&] {
+		if (once) {
+			once = false;
+			sig += cnt;
+			con->disconnect();
+		}
+	};
+	sig += cnt;
+	con = sig + cnt;
+	sig += cnt;
+	sig();
+	CHECK(count == 2);	//新加入的槽留待下一次
+	sig();
+	CHECK(count == 5);
+
+	//删除正在被调用的槽的前驱
+	auto prev = sig + [] {};
+	auto killer = sig + [&] { prev->disconnect(); };
+	count = 0;
+	sig();
+	CHECK(count == 3);
+	CHECK(prev->is_disconnected());
+}
+
+TEST_CASE("Small Function") {
+	using F = SmallFunction<int(int), 32>;
+	F empty;
+	CHECK(!empty);
+	CHECK_THROWS_AS(empty(1), std::bad_function_call);
+
+	int base = 10;
+	F small = [base](int v) { return base + v; };
+	CHECK(small.is_inline());
+	CHECK(small(1) == 11);
+
+	std::array<char, 64> big{};
+	big[0] = 5;
+	F large = [big](int v) { return big[0] + v; };
+	CHECK(!large.is_inline());
+	CHECK(large(1) == 6);
+
+	F copy = large;
+	F moved = std::move(large);
+	CHECK(!large);
+	CHECK(copy(2) == 7);
+	CHECK(moved(2) == 7);
+	CHECK(copy != moved);	//lambda本身不支持==,与EqualableFunction一样视为不等
+	CHECK(copy != small);
+
+	auto neg = makeFunctor<int(int)>([](int v) { return -v; });
+	F wrapped = neg;
+	CHECK(wrapped == neg);
+	CHECK(wrapped.target<decltype(neg)>() != nullptr);
+	CHECK(small.target<decltype(neg)>() == nullptr);
+}
+
+TEST_CASE("Small Signal") {
+	SmallSignal<void(int&)> sig;
+	auto addOne = [](int& v) { ++v; };
+	auto addTwo = [](int& v) { v += 2; };
+	sig += addOne;
+	sig += addTwo;
+	auto con = sig + addOne;
+	int val = 0;
+	sig(val);
+	CHECK(val == 4);
+
+	sig -= addOne;
+	val = 0;
+	sig(val);
+	CHECK(val == 2);
+	CHECK(con->is_disconnected());
+
+	std::string str = "abc";
+	sig += [str](int& v) { v += static_cast<int>(str.size()); };
+	val = 0;
+	sig(val);
+	CHECK(val == 5);
+}
+
+TEST_CASE("Intrusive Signal") {
+	IntrusiveSignal<void(int&)> sig;
+	auto addOne = [](int& v) { ++v; };
+	std::vector<IntrusiveSignal<void(int&)>::Connection> cons;
+	for (int i = 0; i < 100; ++i) {
+		cons.push_back(sig.connect(addOne));
+	}
+	int val = 0;
+	sig(val);
+	CHECK(val == 100);
+
+	cons[3]->block();
+	CHECK(cons[3]->is_blocked());
+	for (int i = 0; i < 100; i += 2) {
+		cons[i]->disconnect();
+	}
+	CHECK(cons[0]->is_disconnected());
+	CHECK(cons[3]->is_connected());
+	val = 0;
+	sig(val);
+	CHECK(val == 49);
+	cons[3]->unblock();
+
+	//节点被新的槽复用之后,旧的句柄依然失效
+	auto reused = sig.connect(addOne);
+	CHECK(reused->is_connected());
+	for (int i = 0; i < 100; i += 2) {
+		CHECK(cons[i]->is_disconnected());
+		cons[i]->disconnect();
+	}
+	val = 0;
+	sig(val);
+	CHECK(val == 51);
+
+	sig -= addOne;
+	CHECK(sig.empty());
+	CHECK(reused->is_disconnected());
+	CHECK(cons[1]->is_disconnected());
+}
+
+TEST_CASE("Intrusive Signal Mutation During Emit") {
+	IntrusiveSignal<void()> sig;
+	int count = 0;
+	auto cnt = [&count] { ++count; };
+	IntrusiveSignal<void()>::Connection con;
+	auto self = sig + [&] {
+		sig += cnt;
+		con->disconnect();
+		con = IntrusiveSignal<void()>::Connection();
+	};
+	sig += cnt;
+	con = sig + cnt;
+	sig += cnt;
+	sig();
+	CHECK(count == 2);
+	self->disconnect();
+	sig();
+	CHECK(count == 5);
+}
+
+namespace {
+	//由槽手动推进的时钟,使耗时可以预期
+	struct ManualClock {
+		using duration = std::chrono::nanoseconds;
+		using rep = duration::rep;
+		using period = duration::period;
+		using time_point = std::chrono::time_point<ManualClock>;
+		static constexpr bool is_steady = true;
+		static rep ticks;
+		static time_point now()noexcept {
+			return time_point(duration(ticks));
+		}
+	};
+	ManualClock::rep ManualClock::ticks = 0;
+
+	void spend(int ns) {
+		ManualClock::ticks += ns;
+	}
+}
+
+TEST_CASE("Instrumented Signal") {
+	static_assert(std::is_same<
+		SelectInstrumentedSlotTraits<EqualableFunction<void(int)>, false>,
+		DefaultSlotTraits<EqualableFunction<void(int)>>>::value, "");
+
+	using Traits = InstrumentedSlotTraits<EqualableFunction<void(int)>, ManualClock>;
+	SimpleSignal<void(int), Traits> sig;
+	sig += spend;
+	auto con = sig + [](int ns) { spend(ns * 1000); };
+	sig += [](int) {};
+	sig(3);
+	sig(5);
+	con->block();
+	sig(100);
+
+	auto stats = snapshotStats(sig);
+	REQUIRE(stats.size() == 3);
+	CHECK(stats[0].callable);
+	CHECK(stats[0].stats.calls == 3);
+	CHECK(stats[0].stats.total == std::chrono::nanoseconds(108));
+	CHECK(stats[0].stats.max == std::chrono::nanoseconds(100));
+	CHECK(stats[0].stats.histogram[1] == 1);	//3ns
+	CHECK(stats[0].stats.histogram[2] == 1);	//5ns
+	CHECK(stats[0].stats.histogram[6] == 1);	//100ns
+
+	CHECK(!stats[1].callable);
+	CHECK(stats[1].stats.calls == 2);
+	CHECK(stats[1].stats.mean() == std::chrono::microseconds(4));
+	CHECK(stats[1].stats.histogram[SlotStats::bucketOf(std::chrono::microseconds(3))] == 1);
+	CHECK(stats[2].stats.calls == 3);
+	CHECK(stats[2].stats.total == std::chrono::nanoseconds(0));
+	CHECK(stats[2].stats.histogram[0] == 3);
+
+	std::ostringstream out;
+	out << stats[0].stats;
+	CHECK(out.str() == "calls=3 total=108ns mean=36ns max=100ns");
+
+	resetStats(sig);
+	CHECK(snapshotStats(sig)[0].stats.calls == 0);
+	sig -= spend;
+	CHECK(snapshotStats(sig).size() == 2);
+}
@@ -0,0 +1,62 @@
+#include <doctest/doctest.h>
+#include <Talg/static_signal.h>
+#include <Talg/slotlist.h>
+#include <string>
+#include <vector>
+using namespace Talg;
+
+namespace {
+	struct SumCombiner {
+		template<class Iter,class Signal>
+		int operator()(Iter first, Iter last, Signal&)const {
+			int sum = 0;
+			for (; first != last; ++first) {
+				if (first) {
+					sum += *first;
+				}
+			}
+			return sum;
+		}
+	};
+	int twice(int v) {
+		return v * 2;
+	}
+}
+
+TEST_CASE("Static Signal") {
+	std::vector<std::string> log;
+	auto sig = makeStaticSignal<void(int, const std::string&)>(
+		[&log](int v, const std::string& s) { log.push_back(s + std::to_string(v)); },
+		[&log](const std::string& s) { log.push_back(s); },
+		[&log](int v) { log.push_back(std::to_string(v)); }
+	);
+	static_assert(decltype(sig)::size() == 3, "");
+	sig(1, std::string("a"));
+	CHECK(log == std::vector<std::string>{ "a1", "a", "1" });
+
+	log.clear();
+	sig.block<1>();
+	CHECK(sig.is_blocked<1>());
+	sig.emit(2, "b");
+	CHECK(log == std::vector<std::string>{ "b2", "2" });
+	sig.unblock<1>();
+	sig.emit(3, "c");
+	CHECK(log.size() == 5);
+}
+
+TEST_CASE("Static Signal Combiner") {
+	auto sig = makeStaticSignal<int(int)>(twice, [](int v) { return v + 1; }, [] { return 100; });
+	CHECK(sig.collect(SumCombiner{}, 5) == 10 + 6 + 100);
+	sig.block<2>();
+	CHECK(sig.collect(SumCombiner{}, 5) == 16);
+
+	//同一个组合器也用于BasicSignal
+	SimpleSignal<int(int)> dyn;
+	dyn += twice;
+	dyn += [](int v) { return v + 1; };
+	CHECK(dyn.collect(SumCombiner{}, 5) == 16);
+
+	StaticSignal<int(int)> none;
+	CHECK(none.empty());
+	CHECK(none.collect(SumCombiner{}, 1) == 0);
+}
@@ -0,0 +1,122 @@
+#include <doctest/doctest.h>
+#include <Talg/timing_wheel.h>
+#include <Talg/slotlist.h>
+#include <functional>
+#include <string>
+#include <algorithm>
+#include <map>
+#include <random>
+#include <sstream>
+#include <vector>
+using namespace Talg;
+
+namespace {
+	using Clock = std::chrono::steady_clock;
+	const Clock::time_point origin{};
+}
+
+TEST_CASE("Timing Wheel") {
+	TimingWheel wheel(1ms, origin);
+	std::vector<int> fired;
+	auto a = wheel.schedule_after(5ms, [&] { fired.push_back(5); });
+	auto b = wheel.schedule_after(3ms, [&] { fired.push_back(3); });
+	auto c = wheel.schedule_at(origin + 200ms, [&] { fired.push_back(200); });
+	CHECK(wheel.size() == 3);
+	CHECK(wheel.pending(a));
+	CHECK(!wheel.pending(TimerId{}));
+
+	CHECK(wheel.advance(origin + 2ms) == 0);
+	CHECK(wheel.next_wakeup() == origin + 3ms);
+	CHECK(wheel.advance(origin + 4ms) == 1);
+	CHECK(fired == std::vector<int>{3});
+	CHECK(!wheel.pending(b));
+	CHECK(!wheel.cancel(b));
+
+	CHECK(wheel.cancel(a));
+	CHECK(!wheel.cancel(a));
+	CHECK(wheel.advance(origin + 199ms) == 0);
+	CHECK(wheel.advance(origin + 200ms) == 1);
+	CHECK(fired == std::vector<int>{3, 200});
+	CHECK(!wheel.pending(c));
+	CHECK(wheel.empty());
+	CHECK(wheel.next_wakeup() == Clock::time_point::max());
+
+	//过去的时间在下一个tick触发,回调中可以继续schedule
+	int count = 0;
+	std::function<void()> again = [&] {
+		if (++count < 3) {
+			wheel.schedule_after(0ms, again);
+		}
+	};
+	wheel.schedule_at(origin, again);
+	CHECK(wheel.advance(origin + 10s) == 3);
+	CHECK(count == 3);
+
+	std::ostringstream out;
+	out << wheel;
+	CHECK(out.str() == "timers=0 tick=1ms elapsed=10000ms");
+}
+
+TEST_CASE("Timing Wheel Fires Signals") {
+	TimingWheel wheel(1ms, origin);
+	SimpleSignal<void(int, const std::string&)> sig;
+	std::string got;
+	sig += [&](int v, const std::string& s) { got += s + std::to_string(v); };
+	wheel.fire_after(1ms, sig, 1, std::string("a"));
+	auto id = wheel.fire_after(2ms, sig, 2, std::string("b"));
+	wheel.fire_after(3ms, sig, 3, std::string("c"));
+	wheel.cancel(id);
+	wheel.advance(origin + 3ms);
+	CHECK(got == "a1c3");
+
+	//超出所有层的范围的定时器
+	BasicTimingWheel<Clock, std::chrono::nanoseconds> fine(1ns, origin);
+	bool far = false;
+	fine.schedule_at(origin + std::chrono::nanoseconds(std::int64_t(1) << 40), [&] { far = true; });
+	fine.advance(origin + std::chrono::nanoseconds((std::int64_t(1) << 40) - 1));
+	CHECK(!far);
+	fine.advance(origin + std::chrono::nanoseconds(std::int64_t(1) << 40));
+	CHECK(far);
+}
+
+TEST_CASE("Timing Wheel Random") {
+	//与按到期时间排序的std::multimap比较
+	TimingWheel wheel(1ms, origin);
+	std::mt19937_64 rng(7);
+	std::map<std::uint32_t, std::pair<std::uint64_t, TimerId>> expect;
+	std::vector<std::pair<std::uint64_t, std::uint32_t>> fired;
+	std::uint32_t next_key = 0;
+	std::uint64_t now = 0;
+	for (int round = 0; round != 2000; ++round) {
+		for (int i = 0; i != 20; ++i) {
+			std::uint64_t delay = rng() % 4 == 0 ? rng() % 20000000 : rng() % 300;
+			auto key = next_key++;
+			auto deadline = now + std::max<std::uint64_t>(delay, 1);
+			auto id = wheel.schedule_at(origin + std::chrono::milliseconds(deadline),
+				[&fired, &wheel, key] { fired.emplace_back(wheel.ticks(), key); });
+			expect[key] = { deadline, id };
+		}
+		for (int i = 0; i != 15 && !expect.empty(); ++i) {
+			auto iter = expect.lower_bound(static_cast<std::uint32_t>(rng() % next_key));
+			if (iter != expect.end()) {
+				CHECK(wheel.cancel(iter->second.second));
+				expect.erase(iter);
+			}
+		}
+		now += rng() % 8 == 0 ? rng() % 100000 : rng() % 50;
+		fired.clear();
+		wheel.advance(origin + std::chrono::milliseconds(now));
+		for (auto& f : fired) {
+			auto iter = expect.find(f.second);
+			REQUIRE(iter != expect.end());
+			CHECK(iter->second.first == f.first);
+			expect.erase(iter);
+		}
+		for (auto& e : expect) {
+			REQUIRE(e.second.first > now);
+		}
+		REQUIRE(wheel.size() == expect.size());
+	}
+	wheel.clear();
+	CHECK(wheel.empty());
+}
@@ -0,0 +1,104 @@
+#include <doctest/doctest.h>
+#include <Talg/tracked_slot.h>
+#include <iterator>
+#include <memory>
+using namespace Talg;
+
+namespace {
+	struct Counter {
+		int count = 0;
+		void add(int v) { count += v; }
+		void inc() { ++count; }
+	};
+}
+
+TEST_CASE("Tracked Signal") {
+	TrackedSignal<void(int)> sig;
+	auto a = std::make_shared<Counter>();
+	auto b = std::make_shared<Counter>();
+	int plain = 0;
+	auto con_a = sig.connect(a, &Counter::add);
+	sig.connect(b, &Counter::inc);
+	auto add_plain = [&plain](int v) { plain += v; };
+	sig += add_plain;
+	sig(2);
+	CHECK(a->count == 2);
+	CHECK(b->count == 1);
+	CHECK(plain == 2);
+
+	std::weak_ptr<Counter> watch = a;
+	a.reset();
+	CHECK(watch.expired());
+	//目标已经析构的槽在emit之前被断开,不会抛出bad_weak_ptr
+	sig(3);
+	CHECK(con_a->is_disconnected());
+	CHECK(b->count == 2);
+	CHECK(plain == 5);
+
+	b.reset();
+	CHECK(sig.purge_expired() == 1);
+	sig -= add_plain;
+	CHECK(sig.empty());
+}
+
+TEST_CASE("Tracked Signal Disconnect") {
+	TrackedSignal<void(int)> sig;
+	auto a = std::make_shared<Counter>();
+	sig.connect(a, &Counter::add);
+	sig.connect(a, &Counter::inc);
+	sig.disconnect(a, &Counter::add);
+	sig(5);
+	CHECK(a->count == 1);
+
+	//在emit期间析构的目标:之后的槽被跳过
+	auto victim = std::make_shared<Counter>();
+	TrackedSignal<void(int)> sig2;
+	sig2 += [&victim](int) { victim.reset(); };
+	sig2.connect(victim, &Counter::add);
+	sig2(1);
+	CHECK(!victim);
+	CHECK(!sig2.empty());
+	sig2(1);
+	CHECK(sig2.purge_expired() == 0);
+}
+
+TEST_CASE("Tracked Signal Purge During Emit") {
+	TrackedSignal<void(int)> sig;
+	auto a = std::make_shared<Counter>();
+	auto b = std::make_shared<Counter>();
+	auto c = std::make_shared<Counter>();
+	sig.connect(a, &Counter::add);
+	auto con_b = sig.connect(b, &Counter::add);
+	auto con_c = sig.connect(c, &Counter::add);
+	b.reset();
+	c.reset();
+	//中间与末尾的失效槽都在这一次emit中断开
+	sig.emit(1);
+	CHECK(a->count == 1);
+	CHECK(con_b->is_disconnected());
+	CHECK(con_c->is_disconnected());
+	CHECK(sig.purge_expired() == 0);
+	sig(1);
+	sig.collect_guarded(TrackedSignal<void(int)>::DefaultResCombiner{}, 1);
+	CHECK(a->count == 3);
+
+	//嵌套的emit不断开节点,留给外层的遍历
+	auto d = std::make_shared<Counter>();
+	bool nested = false;
+	std::ptrdiff_t nested_size = 0;
+	sig += [&](int) {
+		if (!nested) {
+			nested = true;
+			d.reset();
+			sig(0);
+			nested_size = std::distance(sig.slots().begin(), sig.slots().end());
+		}
+	};
+	auto con_d = sig.connect(d, &Counter::add);
+	sig.connect(a, &Counter::inc);
+	sig(1);
+	CHECK(nested_size == 4);
+	CHECK(con_d->is_disconnected());
+	CHECK(a->count == 6);
+	CHECK(sig.purge_expired() == 0);
+}
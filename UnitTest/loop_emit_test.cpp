@@ -47,4 +47,41 @@ TEST_CASE("test multiple same parameter") {
 		CHECK(b == 2);
 	};
 	sig(1, 2, 3, 4);
-}
\ No newline at end of file
+}
+TEST_CASE("Guarded Emit Test") {
+	SimpleSignal<void()> sig;
+	std::ostringstream os;
+	int count = 3;
+	sig += [&] {
+		os << "a " << count << " " << sig.emission_depth() << " ";
+		if (count--) {
+			sig.emit_guarded();
+		}
+	};
+	sig += [&] {
+		os << "b " << count << " " << sig.emission_depth() << " ";
+		if (count--) {
+			sig.emit_guarded();
+		}
+	};
+	sig.emit_guarded();
+	CHECK(os.str() == "a 3 1 b 2 2 b 1 1 a 0 2 ");
+	CHECK(sig.emission_depth() == 0);
+
+	//正在执行的槽不会被断开
+	SimpleSignal<void()> self_discon;
+	int calls = 0;
+	SimpleSignal<void()>::Connection con;
+	con = self_discon + [&] {
+		++calls;
+		con->disconnect();
+		CHECK(con->is_connected());
+	};
+	self_discon.emit_guarded();
+	self_discon.emit_guarded();
+	CHECK(calls == 2);
+	con->disconnect();
+	CHECK(con->is_disconnected());
+	self_discon.emit_guarded();
+	CHECK(calls == 2);
+}